@@ -17,6 +17,10 @@
  *
  * To measure context switch cost:
  *   ./os_measurements context
+ *
+ * To measure both and write them as a profile for the scheduler
+ * simulator (./sched --switch-profile=FILE), to stdout if no file is given:
+ *   ./os_measurements profile [file]
  */
 
 // A helper function to calculate the time difference in microseconds
@@ -26,9 +30,9 @@ long long timeval_diff_us(struct timeval *start, struct timeval *end) {
 
 /**
  * Measures the cost of a minimal system call by timing a tight loop of
- * 0-byte read() calls.
+ * 0-byte read() calls. Returns the average in nanoseconds.
  */
-void measure_syscall() {
+double measure_syscall() {
     struct timeval start, end;
     long long elapsed_us; // us = microseconds
     int iterations = 1000000; // One million iterations
@@ -56,18 +60,21 @@ void measure_syscall() {
 
     printf("Total time for %d iterations: %lld microseconds.\n", iterations, elapsed_us);
     printf("Average time per system call: ~%.2f nanoseconds.\n", average_ns);
+    return average_ns;
 }
 
 /**
  * Measures the cost of a context switch using two processes communicating
- * over two pipes, forcing the OS to switch between them.
+ * over two pipes, forcing the OS to switch between them. Returns the
+ * average in microseconds.
  */
-void measure_context_switch() {
+double measure_context_switch() {
     int pipe1[2]; // Parent writes, Child reads
     int pipe2[2]; // Child writes, Parent reads
     pid_t pid;
     struct timeval start, end;
     int iterations = 100000;
+    double time_per_switch_us;
 
     if (pipe(pipe1) == -1 || pipe(pipe2) == -1) {
         perror("pipe");
@@ -124,16 +131,51 @@ void measure_context_switch() {
 
         long long elapsed_us = timeval_diff_us(&start, &end);
         // Each round trip is 2 context switches (Parent->Child, Child->Parent)
-        double time_per_switch_us = (double)elapsed_us / (iterations * 2.0);
+        time_per_switch_us = (double)elapsed_us / (iterations * 2.0);
 
         printf("Total time for %d round trips: %lld microseconds.\n", iterations, elapsed_us);
         printf("Average time per context switch: ~%.3f microseconds.\n", time_per_switch_us);
     }
+    return time_per_switch_us;
+}
+
+/**
+ * Measures both costs and writes them in the simulator's profile format:
+ * one "key value" line per cost, in microseconds. The measurements' own
+ * output goes to stderr so that the profile can be written to stdout.
+ */
+void write_profile(const char *path) {
+    FILE *out = stdout;
+    double syscall_ns, switch_us;
+
+    if (path && !(out = fopen(path, "w"))) {
+        perror(path);
+        exit(1);
+    }
+
+    // keep stdout for the profile
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+    syscall_ns = measure_syscall();
+    fflush(stdout);     // or the child forked next would print it again
+    switch_us = measure_context_switch();
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    fprintf(out, "# os_measurements profile\n");
+    fprintf(out, "syscall_us %.6f\n", syscall_ns / 1000.0);
+    fprintf(out, "context_switch_us %.6f\n", switch_us);
+    if (out != stdout && fclose(out) == EOF) {
+        perror(path);
+        exit(1);
+    }
 }
 
 int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <syscall | context>\n", argv[0]);
+    if (argc != 2 && !(argc == 3 && strcmp(argv[1], "profile") == 0)) {
+        fprintf(stderr, "Usage: %s <syscall | context | profile [file]>\n", argv[0]);
         exit(1);
     }
 
@@ -141,8 +183,10 @@ int main(int argc, char *argv[]) {
         measure_syscall();
     } else if (strcmp(argv[1], "context") == 0) {
         measure_context_switch();
+    } else if (strcmp(argv[1], "profile") == 0) {
+        write_profile(argc == 3 ? argv[2] : NULL);
     } else {
-        fprintf(stderr, "Invalid measurement type: '%s'. Please use 'syscall' or 'context'.\n", argv[1]);
+        fprintf(stderr, "Invalid measurement type: '%s'. Please use 'syscall', 'context' or 'profile'.\n", argv[1]);
         exit(1);
     }
 
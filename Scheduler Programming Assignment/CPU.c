@@ -3,10 +3,202 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "task.h"
+#include "cpu.h"
+
+// binary records are collected here and written out in one go
+#define LOG_BUFFER_RECORDS (1 << 16)
+
+struct cpu_log {
+    int mode;
+    int cpus;
+    int fd;
+    const char *path;
+    struct log_record *buffer;
+    int used;
+};
 
 // run this task for the specified time slice
 void run(Task *task, int slice) {
     printf("Running task = [%s] [%d] [%d] for %d units.\n",task->name, task->priority, task->burst, slice);
-}
\ No newline at end of file
+}
+
+// run this task on one CPU of a multi-CPU system, starting at the given time
+void run_on(int cpu, long long time, Task *task, int slice) {
+    printf("[%lld] CPU %d: Running task = [%s] [%d] [%d] for %d units.\n", time, cpu, task->name, task->priority, task->burst, slice);
+}
+
+// the task was preempted before its slice ended
+void preempt(Task *task) {
+    printf("Preempted task = [%s] [%d] [%d].\n", task->name, task->priority, task->burst);
+}
+
+void preempt_on(int cpu, long long time, Task *task) {
+    printf("[%lld] CPU %d: Preempted task = [%s] [%d] [%d].\n", time, cpu, task->name, task->priority, task->burst);
+}
+
+int cpu_load_profile(const char *path, double unit_us, double *switch_cost, double *resume_cost) {
+    FILE *file = fopen(path, "r");
+    double syscall_us = 0, switch_us = -1;
+    char line[256], key[64];
+    double value;
+    int n = 0;
+
+    if (!file) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    while (fgets(line, sizeof(line), file)) {
+        n++;
+        if (line[0] == '#' || sscanf(line, "%63s", key) != 1)
+            continue;
+        if (sscanf(line, "%63s %lf", key, &value) != 2 || value < 0) {
+            fprintf(stderr, "%s:%d: expected a key and a cost\n", path, n);
+            fclose(file);
+            return -1;
+        }
+        if (strcmp(key, PROFILE_SYSCALL) == 0)
+            syscall_us = value;
+        else if (strcmp(key, PROFILE_SWITCH) == 0)
+            switch_us = value;
+    }
+    fclose(file);
+    if (switch_us < 0) {
+        fprintf(stderr, "%s: no %s in the profile\n", path, PROFILE_SWITCH);
+        return -1;
+    }
+
+    *switch_cost = switch_us / unit_us;
+    *resume_cost = syscall_us / unit_us;
+    return 0;
+}
+
+static int write_all(int fd, const void *buf, size_t len) {
+    const char *p = buf;
+
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+static void flush(struct cpu_log *log) {
+    if (log->used == 0)
+        return;
+    if (write_all(log->fd, log->buffer, log->used * sizeof(struct log_record)) == -1) {
+        fprintf(stderr, "%s: %s\n", log->path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    log->used = 0;
+}
+
+struct cpu_log *cpu_log_open(int mode, const char *path, int cpus) {
+    struct cpu_log *log = calloc(1, sizeof(struct cpu_log));
+    if (!log) {
+        fprintf(stderr, "calloc failed in cpu_log_open()\n");
+        exit(EXIT_FAILURE);
+    }
+    log->mode = mode;
+    log->cpus = cpus;
+    log->fd = -1;
+
+    if (mode == TRACE_BINARY) {
+        struct log_header header;
+
+        log->path = path;
+        log->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (log->fd == -1) {
+            fprintf(stderr, "%s: %s\n", path, strerror(errno));
+            free(log);
+            return NULL;
+        }
+        log->buffer = malloc(LOG_BUFFER_RECORDS * sizeof(struct log_record));
+        if (!log->buffer) {
+            fprintf(stderr, "malloc failed in cpu_log_open()\n");
+            exit(EXIT_FAILURE);
+        }
+
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, LOG_MAGIC, sizeof(header.magic));
+        header.version = LOG_VERSION;
+        header.cpus = cpus;
+        if (write_all(log->fd, &header, sizeof(header)) == -1) {
+            fprintf(stderr, "%s: %s\n", path, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+    }
+    return log;
+}
+
+void cpu_log_dispatch(struct cpu_log *log, int cpu, long long start, Task *task, int slice) {
+    struct log_record *rec;
+
+    switch (log->mode) {
+    case TRACE_TEXT:
+        if (log->cpus > 1)
+            run_on(cpu, start, task, slice);
+        else
+            run(task, slice);
+        break;
+
+    case TRACE_BINARY:
+        if (log->used == LOG_BUFFER_RECORDS)
+            flush(log);
+        rec = &log->buffer[log->used++];
+        rec->start = start;
+        rec->tid = task->tid;
+        rec->slice = slice;
+        rec->cpu = cpu;
+        rec->flags = 0;
+        break;
+    }
+}
+
+void cpu_log_preempt(struct cpu_log *log, int cpu, long long time, Task *task, int unused) {
+    struct log_record *rec;
+
+    switch (log->mode) {
+    case TRACE_TEXT:
+        if (log->cpus > 1)
+            preempt_on(cpu, time, task);
+        else
+            preempt(task);
+        break;
+
+    case TRACE_BINARY:
+        if (log->used == LOG_BUFFER_RECORDS)
+            flush(log);
+        rec = &log->buffer[log->used++];
+        rec->start = time;
+        rec->tid = task->tid;
+        rec->slice = unused;
+        rec->cpu = cpu;
+        rec->flags = LOG_PREEMPT;
+        break;
+    }
+}
+
+void cpu_log_close(struct cpu_log *log) {
+    if (log->mode == TRACE_BINARY) {
+        flush(log);
+        if (close(log->fd) == -1) {
+            fprintf(stderr, "%s: %s\n", log->path, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+        free(log->buffer);
+    }
+    free(log);
+}
@@ -0,0 +1,76 @@
+/**
+ * Arena allocator
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "arena.h"
+
+#define BLOCK_SIZE  (1 << 20)
+#define ALIGNMENT   (sizeof(max_align_t))
+
+struct arena_block {
+    struct arena_block *next;
+    size_t size;
+    max_align_t data[];
+};
+
+static struct arena_block *new_block(size_t size) {
+    struct arena_block *block = malloc(sizeof(struct arena_block) + size);
+    if (!block) {
+        fprintf(stderr, "malloc failed in arena_alloc()\n");
+        exit(EXIT_FAILURE);
+    }
+    block->next = NULL;
+    block->size = size;
+    return block;
+}
+
+void *arena_alloc(struct arena *arena, size_t size) {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    // move on to the next block (reused after a reset, or new) if this one is full
+    while (!arena->current || arena->used + size > arena->current->size) {
+        struct arena_block *next = arena->current ? arena->current->next : arena->first;
+
+        if (!next) {
+            next = new_block(size > BLOCK_SIZE ? size : BLOCK_SIZE);
+            if (arena->current)
+                arena->current->next = next;
+            else
+                arena->first = next;
+        }
+        arena->current = next;
+        arena->used = 0;
+    }
+
+    void *p = (char *)arena->current->data + arena->used;
+    arena->used += size;
+    return p;
+}
+
+char *arena_strdup(struct arena *arena, const char *s) {
+    size_t len = strlen(s) + 1;
+    return memcpy(arena_alloc(arena, len), s, len);
+}
+
+void arena_reset(struct arena *arena) {
+    arena->current = NULL;
+    arena->used = 0;
+}
+
+void arena_release(struct arena *arena) {
+    struct arena_block *block = arena->first;
+
+    while (block) {
+        struct arena_block *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->used = 0;
+}
@@ -0,0 +1,34 @@
+/**
+ * Bump allocator for the task data of a simulation run.
+ *
+ * Tasks and names are never freed one at a time; instead the
+ * whole arena is reset between runs. Memory comes from a chain of large
+ * blocks that are kept across resets, so repeated runs reuse it.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+struct arena_block;
+
+struct arena {
+    struct arena_block *first;      // all blocks, in allocation order
+    struct arena_block *current;    // block allocations are served from
+    size_t used;                    // bytes used in the current block
+};
+
+#define ARENA_INIT { NULL, NULL, 0 }
+
+// allocate size bytes; exits if memory is exhausted
+void *arena_alloc(struct arena *arena, size_t size);
+char *arena_strdup(struct arena *arena, const char *s);
+
+// discard every allocation but keep the blocks for the next run
+void arena_reset(struct arena *arena);
+
+// discard every allocation and return the blocks to the system
+void arena_release(struct arena *arena);
+
+#endif
@@ -0,0 +1,224 @@
+/**
+ * bench_sched.c
+ *
+ * Cost of a scheduling decision under every policy.
+ *
+ *  ./bench_sched [--max=N] [--trials=N] [--policy=KEY]
+ *
+ * For task counts from 10 up to max (default 10^7) two loops are timed:
+ *
+ *  pick      the ready queue alone: pick_next() a task, give it a new
+ *            burst and requeue it, with n tasks queued
+ *  dispatch  a whole simulation with output off, per dispatched slice;
+ *            the shortcuts are off too, so every slice counted was
+ *            actually dispatched rather than skipped over in bulk
+ *
+ * Each loop runs once to warm up and then trials times (default 5);
+ * the median and the median absolute deviation of the trials are
+ * reported. Allocations are counted by wrapping malloc, calloc and
+ * realloc at link time. Peak RSS is the process high-water mark so far.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "schedulers.h"
+#include "workload.h"
+#include "arena.h"
+
+// pick_next()/requeue pairs per pick trial
+#define PICK_DECISIONS 1000000L
+
+// dispatches per dispatch trial, at least; small sizes repeat the run
+#define DISPATCH_WORK 200000L
+
+#define MAX_TRIALS 64
+
+static long allocations;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    allocations++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size) {
+    allocations++;
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    allocations++;
+    return __real_realloc(ptr, size);
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+// median of v[0..n), and the median absolute deviation from it; sorts v
+static double median_mad(double *v, int n, double *mad) {
+    double dev[MAX_TRIALS];
+    double median;
+    int i;
+
+    qsort(v, n, sizeof(double), cmp_double);
+    median = n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+    for (i = 0; i < n; i++)
+        dev[i] = v[i] > median ? v[i] - median : median - v[i];
+    qsort(dev, n, sizeof(double), cmp_double);
+    *mad = n % 2 ? dev[n / 2] : (dev[n / 2 - 1] + dev[n / 2]) / 2;
+    return median;
+}
+
+static unsigned int next_burst(unsigned int *seed) {
+    *seed = *seed * 1103515245 + 12345;
+    return 1 + (*seed >> 16) % 100;
+}
+
+// ns per pick_next()/requeue pair with n tasks in the ready queue
+static double pick_trial(const struct policy *policy, void *rq) {
+    unsigned int seed = 139;
+    double start;
+    long i;
+
+    start = now_ns();
+    for (i = 0; i < PICK_DECISIONS; i++) {
+        Task *task = policy->pick_next(rq);
+        task->burst = next_burst(&seed);
+        if (policy->requeue)
+            policy->requeue(rq, task);
+        else
+            policy->enqueue(rq, task);
+    }
+    return (now_ns() - start) / PICK_DECISIONS;
+}
+
+// ns per dispatched slice over whole simulations of the workload
+static double dispatch_trial(struct scheduler *scheduler, const struct workload *workload,
+                             long *allocs) {
+    long long dispatches = 0;
+    double elapsed = 0, start;
+    long before;
+
+    do {
+        struct sim_result result;
+
+        before = allocations;
+        scheduler_add_workload(scheduler, workload);
+        start = now_ns();
+        scheduler_run(scheduler, &result);
+        elapsed += now_ns() - start;
+        *allocs = allocations - before;
+        dispatches += result.dispatches;
+    } while (dispatches < DISPATCH_WORK);
+
+    return elapsed / dispatches;
+}
+
+static void bench(const struct policy *policy, long n, int trials, struct workload *workload) {
+    struct sim_options options = SIM_OPTIONS_INIT;
+    struct arena arena = ARENA_INIT;
+    struct scheduler *scheduler;
+    struct rusage usage;
+    double pick[MAX_TRIALS], dispatch[MAX_TRIALS];
+    double pick_ns, pick_mad, dispatch_ns, dispatch_mad;
+    long allocs = 0;
+    void *rq;
+    long i;
+    int t;
+
+    // the ready queue on its own
+    rq = policy->create(NULL);
+    for (i = 0; i < workload->count; i++) {
+        Task *task = arena_alloc(&arena, sizeof(Task));
+        memset(task, 0, sizeof(Task));
+        task->name = workload->specs[i].name;
+        task->tid = i;
+        task->priority = workload->specs[i].priority;
+        task->burst = task->initial_burst = workload->specs[i].burst;
+        policy->enqueue(rq, task);
+    }
+    pick_trial(policy, rq);
+    for (t = 0; t < trials; t++)
+        pick[t] = pick_trial(policy, rq);
+    policy->destroy(rq);
+    arena_release(&arena);
+
+    // whole simulations
+    options.quiet = 1;
+    options.trace = TRACE_NONE;
+    options.no_shortcuts = 1;
+    scheduler = scheduler_create(policy, &options);
+    dispatch_trial(scheduler, workload, &allocs);
+    for (t = 0; t < trials; t++)
+        dispatch[t] = dispatch_trial(scheduler, workload, &allocs);
+    scheduler_destroy(scheduler);
+
+    pick_ns = median_mad(pick, trials, &pick_mad);
+    dispatch_ns = median_mad(dispatch, trials, &dispatch_mad);
+    getrusage(RUSAGE_SELF, &usage);
+    printf("%-12s %9ld %11.1f %7.1f %11.1f %7.1f %11.3f %9.1f\n", policy->name, n,
+           pick_ns, pick_mad, dispatch_ns, dispatch_mad, (double)allocs / n,
+           usage.ru_maxrss / 1024.0);
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[]) {
+    const struct policy *only = NULL;
+    long max_tasks = 10000000L;
+    int trials = 5;
+    long n, i;
+    int p;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--max=", 6) == 0) {
+            max_tasks = atol(argv[i] + 6);
+        } else if (strncmp(argv[i], "--trials=", 9) == 0) {
+            trials = atoi(argv[i] + 9);
+        } else if (strncmp(argv[i], "--policy=", 9) == 0 && (only = find_policy(argv[i] + 9))) {
+            continue;
+        } else {
+            fprintf(stderr, "Usage: %s [--max=N] [--trials=N] [--policy=KEY]\n", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (trials < 1)
+        trials = 1;
+    if (trials > MAX_TRIALS)
+        trials = MAX_TRIALS;
+
+    printf("%-12s %9s %11s %7s %11s %7s %11s %9s\n", "policy", "tasks", "pick ns", "MAD",
+           "dispatch ns", "MAD", "allocs/task", "RSS MB");
+
+    for (n = 10; n <= max_tasks; n *= 10) {
+        struct workload workload;
+
+        srand(139);
+        workload_init(&workload);
+        for (i = 0; i < n; i++)
+            workload_add(&workload, "T", 1 + rand() % 10, 1 + rand() % 100, NULL, 0, 0, 0, 0);
+
+        for (p = 0; policies[p]; p++)
+            if (!only || policies[p] == only)
+                bench(policies[p], n, trials, &workload);
+
+        workload_free(&workload);
+    }
+    return 0;
+}
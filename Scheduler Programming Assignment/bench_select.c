@@ -0,0 +1,127 @@
+/**
+ * bench_select.c
+ *
+ * Micro-benchmark of shortest-burst selection: the linked-list scan
+ * the schedulers used to do in pickNextTask(), the struct-of-arrays
+ * table with each argmin kernel, and the heap ready queue.
+ *
+ *  ./bench_select [max tasks]
+ *
+ * Task counts go from 10^3 up to max tasks (default 10^7).
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "task.h"
+#include "list.h"
+#include "heap.h"
+#include "arena.h"
+#include "tasktable.h"
+#include "select.h"
+
+// total elements to scan per measurement, so small sizes repeat more
+#define WORK_PER_SIZE 50000000L
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// the selection loop the list-based SJF used
+static Task *list_pick(struct list *list) {
+    Task *temp = list->head;
+    Task *shortest_job = temp;
+
+    while (temp != NULL) {
+        if (temp->burst < shortest_job->burst)
+            shortest_job = temp;
+        temp = temp->next;
+    }
+    return shortest_job;
+}
+
+static void report(int n, const char *impl, double ns, long reps) {
+    double per = ns / reps;
+    printf("%10d  %-14s %14.1f %12.1f\n", n, impl, per, n / per * 1e3);
+}
+
+int main(int argc, char *argv[]) {
+    long max_tasks = argc > 1 ? atol(argv[1]) : 10000000L;
+    enum select_impl impls[] = { SELECT_SCALAR, SELECT_SSE41, SELECT_AVX2 };
+    struct arena arena = ARENA_INIT;
+    volatile long sink = 0;
+    long n;
+
+    srand(139);
+    printf("%10s  %-14s %14s %12s\n", "tasks", "impl", "ns/select", "Mtasks/s");
+
+    for (n = 1000; n <= max_tasks; n *= 10) {
+        long reps = WORK_PER_SIZE / n > 3 ? WORK_PER_SIZE / n : 3;
+        struct list list = LIST_INIT;
+        struct task_table table;
+        struct heap heap;
+        double start;
+        long i, r;
+
+        tt_init(&table);
+        heap_init(&heap, cmp_burst);
+        for (i = 0; i < n; i++) {
+            Task *task = arena_alloc(&arena, sizeof(Task));
+            task->name = NULL;
+            task->tid = i;
+            task->priority = 1 + rand() % 10;
+            task->burst = 1 + rand() % 1000000;
+            append(&list, task);
+            heap_push(&heap, task);
+            tt_add(&table, i, task->priority, task->burst, 0);
+        }
+
+        // linked list, as the schedulers did before the heap
+        start = now_ns();
+        for (r = 0; r < reps; r++)
+            sink += list_pick(&list)->burst;
+        report(n, "list", now_ns() - start, reps);
+
+        // struct-of-arrays table with each kernel this CPU has
+        int expect = -1;
+        for (i = 0; i < (long)(sizeof(impls) / sizeof(impls[0])); i++) {
+            if (select_use(impls[i]) == -1)
+                continue;
+            int got = argmin_i32(table.burst, table.count);
+            if (expect == -1)
+                expect = got;
+            else if (got != expect)
+                fprintf(stderr, "%s argmin disagrees: %d vs %d\n", select_impl_name(), got, expect);
+
+            start = now_ns();
+            for (r = 0; r < reps; r++)
+                sink += argmin_i32(table.burst, table.count);
+            char name[32];
+            snprintf(name, sizeof(name), "table/%s", select_impl_name());
+            report(n, name, now_ns() - start, reps);
+        }
+
+        // heap: pop the shortest job and push it back, the steady-state cost
+        long heap_reps = reps * 100;
+        start = now_ns();
+        for (r = 0; r < heap_reps; r++) {
+            Task *task = heap_pop(&heap);
+            sink += task->burst;
+            heap_push(&heap, task);
+        }
+        report(n, "heap", now_ns() - start, heap_reps);
+
+        heap_free(&heap);
+        tt_free(&table);
+        arena_reset(&arena);
+    }
+
+    select_use(SELECT_AUTO);
+    arena_release(&arena);
+    return sink == 42;
+}
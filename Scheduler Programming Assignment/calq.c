@@ -0,0 +1,297 @@
+/**
+ * Calendar queue operations
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "calq.h"
+
+#define MIN_BUCKETS 2
+#define SAMPLE_SIZE 25
+
+// average buckets a dequeue may look at before the width is chosen again
+#define MAX_VISITS 4
+
+// total order of events: time, then type, then insertion order
+static int before(const struct event *a, const struct event *b) {
+    if (a->time != b->time)
+        return a->time < b->time;
+    if (a->type != b->type)
+        return a->type < b->type;
+    return a->seq < b->seq;
+}
+
+static struct event **new_buckets(int n) {
+    struct event **buckets = calloc(n, sizeof(struct event *));
+    if (!buckets) {
+        fprintf(stderr, "calloc failed in calq\n");
+        exit(EXIT_FAILURE);
+    }
+    return buckets;
+}
+
+static int bitmap_words(int n) {
+    return (n + 63) / 64;
+}
+
+static unsigned long long *new_bitmap(int n) {
+    unsigned long long *bits = calloc(bitmap_words(n), sizeof(unsigned long long));
+    if (!bits) {
+        fprintf(stderr, "calloc failed in calq\n");
+        exit(EXIT_FAILURE);
+    }
+    return bits;
+}
+
+// distance from bucket i forward to the next non-empty bucket (the queue must not be empty)
+static int next_occupied(const struct calq *q, int i) {
+    int words = bitmap_words(q->nbuckets);
+    int w = i / 64;
+    unsigned long long bits = q->occupied[w] & (~0ULL << (i % 64));
+    int b, k;
+
+    if (bits)
+        return w * 64 + __builtin_ctzll(bits) - i;
+
+    for (k = 0; !bits && k < words; k++) {
+        w = w + 1 < words ? w + 1 : 0;
+        bits = q->occupied[w];
+    }
+    b = w * 64 + __builtin_ctzll(bits);
+    return b >= i ? b - i : b - i + q->nbuckets;
+}
+
+void calq_init(struct calq *q) {
+    q->nbuckets = MIN_BUCKETS;
+    q->buckets = new_buckets(q->nbuckets);
+    q->occupied = new_bitmap(q->nbuckets);
+    q->width = 1;
+    q->size = 0;
+    q->seq = 0;
+    q->cur = 0;
+    q->cur_top = q->width;
+    q->last_time = 0;
+    q->visits = 0;
+    q->dequeues = 0;
+}
+
+void calq_free(struct calq *q) {
+    free(q->buckets);
+    free(q->occupied);
+    q->buckets = NULL;
+    q->occupied = NULL;
+    q->nbuckets = 0;
+    q->size = 0;
+}
+
+static int bucket_of(struct calq *q, long long time) {
+    return (int)((time / q->width) % q->nbuckets);
+}
+
+// put the cursor on the window holding time
+static void set_cursor(struct calq *q, long long time) {
+    q->last_time = time;
+    q->cur = bucket_of(q, time);
+    q->cur_top = (time / q->width + 1) * q->width;
+}
+
+/*
+ * Sorted insert into a bucket. The bucket is circular, so its tail is
+ * head->prev; walking back from the tail makes the common case of
+ * events arriving in time order O(1).
+ */
+static void bucket_insert(struct calq *q, struct event *ev) {
+    int b = bucket_of(q, ev->time);
+    struct event *head = q->buckets[b];
+
+    if (!head) {
+        ev->next = ev->prev = ev;
+        q->buckets[b] = ev;
+        q->occupied[b / 64] |= 1ULL << (b % 64);
+    } else {
+        struct event *pos = head->prev;
+        while (before(ev, pos) && pos != head)
+            pos = pos->prev;
+        if (before(ev, pos)) {
+            // new minimum of the bucket
+            ev->next = head;
+            ev->prev = head->prev;
+            head->prev->next = ev;
+            head->prev = ev;
+            q->buckets[b] = ev;
+        } else {
+            ev->prev = pos;
+            ev->next = pos->next;
+            pos->next->prev = ev;
+            pos->next = ev;
+        }
+    }
+    q->size++;
+
+    // an event before the cursor (e.g. after a peek) moves the cursor back
+    if (ev->time < q->last_time)
+        set_cursor(q, ev->time);
+}
+
+static void bucket_remove(struct calq *q, struct event *ev) {
+    int b = bucket_of(q, ev->time);
+
+    if (ev->next == ev) {
+        q->buckets[b] = NULL;
+        q->occupied[b / 64] &= ~(1ULL << (b % 64));
+    } else {
+        ev->prev->next = ev->next;
+        ev->next->prev = ev->prev;
+        if (q->buckets[b] == ev)
+            q->buckets[b] = ev->next;
+    }
+    ev->next = ev->prev = NULL;
+    q->size--;
+}
+
+// find the earliest event and move the cursor to it
+static struct event *find_min(struct calq *q) {
+    struct event *best = NULL;
+    long long top = q->cur_top;
+    int i = q->cur;
+    int k;
+
+    if (q->size == 0)
+        return NULL;
+
+    // walk one year of days from the cursor, skipping empty ones
+    for (k = 0; k < q->nbuckets; k++) {
+        struct event *ev = q->buckets[i];
+
+        if (!ev) {
+            int skip = next_occupied(q, i);
+            if (k + skip >= q->nbuckets)
+                break;
+            k += skip;
+            i = (i + skip) % q->nbuckets;
+            top += skip * q->width;
+            ev = q->buckets[i];
+        }
+        q->visits++;
+        if (ev->time < top) {
+            q->cur = i;
+            q->cur_top = top;
+            q->last_time = ev->time;
+            return ev;
+        }
+        i = (i + 1) % q->nbuckets;
+        top += q->width;
+    }
+
+    // nothing within a year (a long idle gap): search the bucket heads directly
+    for (i = 0; i < q->nbuckets; i++)
+        if (q->buckets[i] && (!best || before(q->buckets[i], best)))
+            best = q->buckets[i];
+    set_cursor(q, best->time);
+    return best;
+}
+
+/*
+ * Rebuild with nbuckets buckets, choosing the width from the average
+ * separation of the next few events (ignoring outliers), but no less
+ * than a year holding every event queued: the next few events may be
+ * one tight cluster while the rest are spread far beyond it.
+ */
+static void resize(struct calq *q, int nbuckets) {
+    struct event *sample[SAMPLE_SIZE];
+    long long saved_time = q->last_time;
+    struct event *all = NULL;
+    long long last = saved_time;
+    int nsample = 0;
+    int i;
+
+    while (nsample < SAMPLE_SIZE && q->size > 0) {
+        struct event *ev = find_min(q);
+        bucket_remove(q, ev);
+        sample[nsample++] = ev;
+    }
+
+    if (nsample >= 2) {
+        long long span = sample[nsample - 1]->time - sample[0]->time;
+        double avg = (double)span / (nsample - 1);
+        double sum = 0;
+        int n = 0;
+
+        for (i = 1; i < nsample; i++) {
+            long long gap = sample[i]->time - sample[i - 1]->time;
+            if (gap <= 2 * avg) {
+                sum += gap;
+                n++;
+            }
+        }
+        q->width = n > 0 && sum > 0 ? (long long)(3 * sum / n) : 1;
+        if (q->width < 1)
+            q->width = 1;
+    }
+
+    // unlink everything still queued into one chain
+    for (i = 0; i < q->nbuckets; i++) {
+        struct event *head = q->buckets[i];
+        if (!head)
+            continue;
+        if (head->prev->time > last)
+            last = head->prev->time;
+        head->prev->next = all;
+        all = head;
+    }
+    if (nsample > 0 && (last - sample[0]->time) / nbuckets + 1 > q->width)
+        q->width = (last - sample[0]->time) / nbuckets + 1;
+
+    free(q->buckets);
+    free(q->occupied);
+    q->buckets = new_buckets(nbuckets);
+    q->occupied = new_bitmap(nbuckets);
+    q->nbuckets = nbuckets;
+    q->size = 0;
+    q->visits = 0;
+    q->dequeues = 0;
+    set_cursor(q, saved_time);
+
+    for (i = 0; i < nsample; i++)
+        bucket_insert(q, sample[i]);
+    while (all) {
+        struct event *next = all->next;
+        bucket_insert(q, all);
+        all = next;
+    }
+}
+
+void calq_insert(struct calq *q, struct event *ev) {
+    ev->seq = q->seq++;
+    bucket_insert(q, ev);
+    if (q->size > 2 * q->nbuckets)
+        resize(q, 2 * q->nbuckets);
+}
+
+struct event *calq_peek(struct calq *q) {
+    return find_min(q);
+}
+
+struct event *calq_pop(struct calq *q) {
+    struct event *ev = find_min(q);
+
+    if (!ev)
+        return NULL;
+    calq_remove(q, ev);
+
+    // once a year of dequeues, check the width still suits the events queued
+    if (++q->dequeues >= q->nbuckets) {
+        if (q->visits > (long long)MAX_VISITS * q->dequeues)
+            resize(q, q->nbuckets);
+        q->visits = 0;
+        q->dequeues = 0;
+    }
+    return ev;
+}
+
+void calq_remove(struct calq *q, struct event *ev) {
+    bucket_remove(q, ev);
+    if (q->nbuckets > MIN_BUCKETS && q->size < q->nbuckets / 2 - 2)
+        resize(q, q->nbuckets / 2);
+}
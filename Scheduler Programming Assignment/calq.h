@@ -0,0 +1,59 @@
+/**
+ * Calendar queue of simulation events (R. Brown, CACM 1988).
+ *
+ * Events are hashed by time into an array of buckets, each a "day" of
+ * the calendar; a bucket holds its events sorted. Dequeuing walks the
+ * days from the current one, so with a well-chosen bucket width insert
+ * and remove are O(1) on average. The width and bucket count adapt as
+ * the queue grows and shrinks, and the width is chosen again when
+ * dequeues start visiting many buckets, e.g. once events that all
+ * began in one cluster have spread out. A bitmap of the non-empty days
+ * lets the walk skip empty ones a word at a time, so clusters of events
+ * far apart (e.g. periodic releases) do not cost a day each.
+ *
+ * Events with equal times come out in (type, insertion) order.
+ */
+
+#ifndef CALQ_H
+#define CALQ_H
+
+#include "task.h"
+
+struct event {
+    long long time;
+    int type;
+    int cpu;
+    unsigned long seq;
+    Task *task;
+    struct event *next;     // bucket links; each bucket is a circular list
+    struct event *prev;
+};
+
+struct calq {
+    struct event **buckets;
+    unsigned long long *occupied;   // bit b set if bucket b is non-empty
+    int nbuckets;
+    long long width;        // time span of one bucket
+    int size;
+    unsigned long seq;
+    int cur;                // bucket of the last event dequeued
+    long long cur_top;      // end of the current bucket's window
+    long long last_time;    // time of the last event dequeued
+    long long visits;       // buckets looked at by dequeues since the last resize
+    int dequeues;
+};
+
+void calq_init(struct calq *q);
+void calq_free(struct calq *q);
+
+// events must not be earlier than the last one dequeued
+void calq_insert(struct calq *q, struct event *ev);
+
+// earliest event, or NULL if empty; peek leaves it queued
+struct event *calq_peek(struct calq *q);
+struct event *calq_pop(struct calq *q);
+
+// remove a queued event, e.g. a preempted task's completion
+void calq_remove(struct calq *q, struct event *ev);
+
+#endif
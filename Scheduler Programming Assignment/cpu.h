@@ -1,5 +1,88 @@
+#ifndef CPU_H
+#define CPU_H
+
+#include <stdint.h>
+
+#include "task.h"
+
 // length of a time quantum
 #define QUANTUM 10
 
 // run the specified task for the following time slice
-void run(Task *task, int slice);
\ No newline at end of file
+void run(Task *task, int slice);
+
+// run the specified task on one of several CPUs, starting at the given time
+void run_on(int cpu, long long time, Task *task, int slice);
+
+// the specified task was preempted and has task->burst left
+void preempt(Task *task);
+void preempt_on(int cpu, long long time, Task *task);
+
+/*
+ * Dispatch costs measured on a real machine, as written by
+ * "os_measurements profile": one "key value" pair per line, with
+ * syscall_us the cost of a system call and context_switch_us the cost
+ * of a switch between processes, in microseconds. Lines starting with
+ * '#' are comments.
+ */
+#define PROFILE_SYSCALL "syscall_us"
+#define PROFILE_SWITCH  "context_switch_us"
+
+// read a profile and convert it to time units of unit_us microseconds:
+// a context switch costs *switch_cost and resuming the task that ran
+// last, which only enters and leaves the kernel, *resume_cost.
+// Returns -1, having printed why, if the file cannot be used.
+int cpu_load_profile(const char *path, double unit_us, double *switch_cost, double *resume_cost);
+
+/*
+ * Dispatch log. Every slice the simulator hands to a CPU is recorded
+ * either as the text printed by run()/run_on(), as a fixed-size binary
+ * record in a buffered file, or not at all.
+ */
+enum {
+    TRACE_TEXT,
+    TRACE_BINARY,
+    TRACE_NONE
+};
+
+#define LOG_MAGIC   "SCHEDLOG"
+#define LOG_VERSION 2
+
+// start of a binary log file
+struct log_header {
+    char magic[8];          // LOG_MAGIC, not NUL-terminated
+    int32_t version;
+    int32_t cpus;
+};
+
+// record flags
+#define LOG_PREEMPT 0x1     // a preemption at start, giving back slice units of the last slice
+
+// one dispatched slice; records follow the header back to back.
+// Version 1 logs have no flags and record a preemption as a negative
+// slice, which cannot tell a preemption with nothing left apart from
+// an empty dispatch.
+struct log_record {
+    int64_t start;
+    int32_t tid;
+    int32_t slice;
+    int32_t cpu;
+    int32_t flags;          // LOG_PREEMPT
+};
+
+struct cpu_log;
+
+// open a log of the given mode; path is only used for TRACE_BINARY
+struct cpu_log *cpu_log_open(int mode, const char *path, int cpus);
+
+// record that task runs for slice units on cpu from time start
+void cpu_log_dispatch(struct cpu_log *log, int cpu, long long start, Task *task, int slice);
+
+// record that task was preempted at time with unused units of its slice
+// left; task->burst already includes them
+void cpu_log_preempt(struct cpu_log *log, int cpu, long long time, Task *task, int unused);
+
+// flush and free the log
+void cpu_log_close(struct cpu_log *log);
+
+#endif
@@ -3,47 +3,193 @@
  *
  * Schedule is in the format
  *
- *  [name] [priority] [CPU burst]
+ *  [name] [priority] [CPU burst] [arrival time] [deadline] [period]
+ *
+ * where the last three are optional. The CPU burst can be followed by
+ * I/O bursts, each with the CPU burst after it: 10/20/5 runs for 10,
+ * waits 20 on device 0, then runs for 5, and 10/20@1/5 uses device 1.
+ *
+ * or is a binary .sched file (see sched_format.h and ./schedconv).
+ *
+ * Usage: ./sched --policy=<policy> [--cpus=N] [--trace=text|binary|none]
+ *                [--log=FILE] [--quiet] [--online] [--interval=T] [--no-shortcuts]
+ *                [--params=P] [--horizon=T] [--switch-cost=C] [--resume-cost=C]
+ *                [--switch-profile=FILE] [--time-unit=US] <schedule file>
+ *
+ * The binary carries every policy. When it is installed under a
+ * policy's name (./rr, ./sjf, ...) that policy is the default.
+ *
+ * --trace=binary writes each dispatch as a fixed-size record to the log
+ * file (sched.log by default) instead of printing it; ./logdump turns
+ * such a log back into text. --quiet is short for --trace=none and
+ * prints only the metrics.
+ *
+ * --online reads the schedule from a stream ("-" for stdin, or a FIFO)
+ * while the simulation runs; tasks must come in order of arrival and
+ * are freed once they complete. --interval=T prints running metrics
+ * every T time units.
+ *
+ * Metrics-only runs take shortcuts: FCFS, SJF and Priority are computed
+ * without simulating when every task arrives at 0, and RR and Priority
+ * RR skip whole rounds in which no task completes. --no-shortcuts turns
+ * them off.
+ *
+ * A task with a period is released again every period. --horizon=T
+ * stops the releases at time T; by default they run for one hyperperiod
+ * after the last periodic task arrives.
+ *
+ * Dispatching is free by default. --switch-cost=C makes every context
+ * switch take C time units (fractions allowed) and --resume-cost=C
+ * every dispatch of the task that ran last. --switch-profile reads
+ * both from a profile written by "os_measurements profile", with one
+ * time unit taken to be --time-unit microseconds (default 1000, so
+ * bursts are in milliseconds); the other two options override it.
+ * The metrics then include the share of CPU time lost to switching.
+ *
+ * --params passes policy parameters, e.g. --params=levels=4,boost=500
+ * for mlfq; see the policy's source for what it accepts.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#include "task.h"
-#include "list.h"
 #include "schedulers.h"
+#include "trace.h"
+#include "online.h"
+#include "sim.h"
 
-#define SIZE    100
+static void usage(const char *prog)
+{
+    int i;
+
+    fprintf(stderr, "Usage: %s [--policy=<policy>] [--cpus=N] [--trace=text|binary|none]\n"
+                    "       [--log=FILE] [--quiet] [--online] [--interval=T] [--no-shortcuts]\n"
+                    "       [--params=P] [--horizon=T] [--switch-cost=C] [--resume-cost=C]\n"
+                    "       [--switch-profile=FILE] [--time-unit=US] <schedule file>\n", prog);
+    fprintf(stderr, "Policies:");
+    for (i = 0; policies[i]; i++)
+        fprintf(stderr, " %s", policies[i]->key);
+    fprintf(stderr, "\n");
+    exit(EXIT_FAILURE);
+}
+
+// schedule tasks as they are read from a stream
+static int run_online(const struct policy *policy, const struct sim_options *options, const char *file)
+{
+    struct scheduler *scheduler;
+    struct task_source source;
+    struct online online;
+
+    if (online_open(&online, file) == -1)
+        exit(EXIT_FAILURE);
+    online_source(&online, &source);
+
+    scheduler = scheduler_create(policy, options);
+    scheduler_run_source(scheduler, &source, NULL);
+    scheduler_destroy(scheduler);
+
+    online_close(&online);
+    if (online.errors > 0) {
+        fprintf(stderr, "%s: %d malformed line%s skipped\n", online.path, online.errors,
+                online.errors == 1 ? "" : "s");
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
 
 int main(int argc, char *argv[])
 {
-    FILE *in;
-    char *temp;
-    char task[SIZE];
-
-    char *name;
-    int priority;
-    int burst;
-
-    in = fopen(argv[1],"r");
-    
-    while (fgets(task,SIZE,in) != NULL) {
-        temp = strdup(task);
-        name = strsep(&temp,",");
-        priority = atoi(strsep(&temp,","));
-        burst = atoi(strsep(&temp,","));
-
-        // add the task to the scheduler's list of tasks
-        add(name,priority,burst);
-
-        free(temp);
+    struct sim_options options = SIM_OPTIONS_INIT;
+    const struct policy *policy;
+    struct scheduler *scheduler;
+    struct trace trace;
+    const char *prog;
+    char *file = NULL;
+    const char *profile = NULL;
+    double switch_cost = -1, resume_cost = -1, unit_us = 1000;
+    int online = 0;
+    int errors;
+    int i;
+
+    // default to the policy the program is named after, if any
+    prog = strrchr(argv[0], '/') ? strrchr(argv[0], '/') + 1 : argv[0];
+    policy = find_policy(prog);
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--policy=", 9) == 0) {
+            if (!(policy = find_policy(argv[i] + 9))) {
+                fprintf(stderr, "%s: unknown policy '%s'\n", prog, argv[i] + 9);
+                usage(argv[0]);
+            }
+        } else if (strncmp(argv[i], "--cpus=", 7) == 0) {
+            options.cpus = atoi(argv[i] + 7);
+        } else if (strcmp(argv[i], "--trace=text") == 0) {
+            options.trace = TRACE_TEXT;
+        } else if (strcmp(argv[i], "--trace=binary") == 0) {
+            options.trace = TRACE_BINARY;
+        } else if (strcmp(argv[i], "--trace=none") == 0 || strcmp(argv[i], "--quiet") == 0) {
+            options.trace = TRACE_NONE;
+        } else if (strncmp(argv[i], "--log=", 6) == 0) {
+            options.trace_path = argv[i] + 6;
+        } else if (strncmp(argv[i], "--params=", 9) == 0) {
+            options.params = argv[i] + 9;
+        } else if (strncmp(argv[i], "--horizon=", 10) == 0) {
+            options.horizon = atoll(argv[i] + 10);
+        } else if (strncmp(argv[i], "--switch-cost=", 14) == 0) {
+            switch_cost = atof(argv[i] + 14);
+        } else if (strncmp(argv[i], "--resume-cost=", 14) == 0) {
+            resume_cost = atof(argv[i] + 14);
+        } else if (strncmp(argv[i], "--switch-profile=", 17) == 0) {
+            profile = argv[i] + 17;
+        } else if (strncmp(argv[i], "--time-unit=", 12) == 0) {
+            unit_us = atof(argv[i] + 12);
+        } else if (strcmp(argv[i], "--no-shortcuts") == 0) {
+            options.no_shortcuts = 1;
+        } else if (strcmp(argv[i], "--online") == 0) {
+            online = 1;
+        } else if (strncmp(argv[i], "--interval=", 11) == 0) {
+            options.interval = atoll(argv[i] + 11);
+        } else if (strcmp(argv[i], "-") == 0 && !file) {
+            file = argv[i];
+        } else if (argv[i][0] != '-' && !file) {
+            file = argv[i];
+        } else {
+            usage(argv[0]);
+        }
     }
+    if (!file || !policy || options.cpus < 1 || unit_us <= 0)
+        usage(argv[0]);
+    if (profile && cpu_load_profile(profile, unit_us, &options.switch_cost, &options.resume_cost) == -1)
+        exit(EXIT_FAILURE);
+    if (switch_cost >= 0)
+        options.switch_cost = switch_cost;
+    if (resume_cost >= 0)
+        options.resume_cost = resume_cost;
+    if (!options.trace_path)
+        options.trace_path = "sched.log";
+
+    if (online)
+        return run_online(policy, &options, file);
 
-    fclose(in);
+    if (trace_open(&trace, file) == -1)
+        exit(EXIT_FAILURE);
+
+    // add the tasks to the scheduler's list of tasks
+    scheduler = scheduler_create(policy, &options);
+    errors = trace_load(&trace, scheduler_add, scheduler);
+    if (errors > 0) {
+        fprintf(stderr, "%s: %d malformed line%s\n", file, errors, errors == 1 ? "" : "s");
+        trace_close(&trace);
+        exit(EXIT_FAILURE);
+    }
 
     // invoke the scheduler
-    schedule();
+    scheduler_run(scheduler, NULL);
+
+    // task names point into the trace, so unmap it only now
+    scheduler_destroy(scheduler);
+    trace_close(&trace);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,334 @@
+/**
+ * Synthetic workload generator.
+ *
+ * Usage: ./gen [--count=N] [--seed=S] [--burst=DIST] [--arrival=DIST]
+ *              [--priorities=MIX] [--io=DIST] [--io-bursts=N] [--devices=D]
+ *              [--format=text|binary] [--out=FILE]
+ *
+ * DIST is one of
+ *
+ *  const:V              always V
+ *  exp:MEAN             exponential
+ *  bimodal:S,L,P        exponential with mean S with probability P, else mean L
+ *  pareto:ALPHA,MIN     Pareto heavy tail starting at MIN
+ *  none                 (arrival only) every task arrives at time 0
+ *
+ * --arrival gives the time between consecutive arrivals. MIX is
+ * "uniform" or a comma-separated list of weights for priorities 1, 2, ...
+ *
+ * With --io, every task does --io-bursts I/O bursts (default 1) drawn
+ * from DIST, each on one of D devices (default 1) picked at random and
+ * followed by a CPU burst drawn like the first. I/O bursts come from a
+ * random stream of their own, so adding them leaves the rest of the
+ * trace as it was.
+ *
+ * Tasks are generated and written one at a time, so memory use does not
+ * depend on the count. The same seed always gives the same trace.
+ * Text output is the format driver.c reads; binary output is the .sched
+ * format described in sched_format.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+
+#include "sched_format.h"
+#include "task.h"
+
+#define MAX_PRIORITY_CLASSES 10
+#define OUT_BUFFER (1 << 20)
+
+enum {
+    DIST_NONE,
+    DIST_CONST,
+    DIST_EXP,
+    DIST_BIMODAL,
+    DIST_PARETO
+};
+
+struct dist {
+    int kind;
+    double a, b, p;
+};
+
+// the I/O stream starts this far from the main one
+#define IO_STREAM 0x2545f4914f6cdd1dULL
+
+// splitmix64
+static uint64_t rng_next(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// uniform in (0, 1]
+static double rng_uniform(uint64_t *state) {
+    return ((rng_next(state) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+static double sample(const struct dist *d, uint64_t *state) {
+    switch (d->kind) {
+    case DIST_CONST:
+        return d->a;
+    case DIST_EXP:
+        return -d->a * log(rng_uniform(state));
+    case DIST_BIMODAL:
+        return -(rng_uniform(state) <= d->p ? d->a : d->b) * log(rng_uniform(state));
+    case DIST_PARETO:
+        return d->b * pow(rng_uniform(state), -1.0 / d->a);
+    }
+    return 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--count=N] [--seed=S] [--burst=DIST] [--arrival=DIST]\n"
+                    "       [--priorities=uniform|W1,W2,...] [--io=DIST] [--io-bursts=N] [--devices=D]\n"
+                    "       [--format=text|binary] [--out=FILE]\n"
+                    "DIST: const:V | exp:MEAN | bimodal:SHORT,LONG,P | pareto:ALPHA,MIN | none\n", prog);
+    exit(EXIT_FAILURE);
+}
+
+static int parse_dist(const char *s, struct dist *d) {
+    memset(d, 0, sizeof(*d));
+    if (strcmp(s, "none") == 0) {
+        d->kind = DIST_NONE;
+        return 0;
+    }
+    if (sscanf(s, "const:%lf", &d->a) == 1 && d->a >= 0) {
+        d->kind = DIST_CONST;
+        return 0;
+    }
+    if (sscanf(s, "exp:%lf", &d->a) == 1 && d->a > 0) {
+        d->kind = DIST_EXP;
+        return 0;
+    }
+    if (sscanf(s, "bimodal:%lf,%lf,%lf", &d->a, &d->b, &d->p) == 3 &&
+        d->a > 0 && d->b > 0 && d->p >= 0 && d->p <= 1) {
+        d->kind = DIST_BIMODAL;
+        return 0;
+    }
+    if (sscanf(s, "pareto:%lf,%lf", &d->a, &d->b) == 2 && d->a > 0 && d->b > 0) {
+        d->kind = DIST_PARETO;
+        return 0;
+    }
+    return -1;
+}
+
+// cumulative weights of priorities 1..n; returns n, or -1 if malformed
+static int parse_mix(const char *s, double *cumulative) {
+    double total = 0;
+    char *end;
+    int n = 0, i;
+
+    if (strcmp(s, "uniform") == 0) {
+        for (i = 0; i < MAX_PRIORITY_CLASSES; i++)
+            cumulative[i] = (i + 1.0) / MAX_PRIORITY_CLASSES;
+        return MAX_PRIORITY_CLASSES;
+    }
+    while (*s && n < MAX_PRIORITY_CLASSES) {
+        double w = strtod(s, &end);
+        if (end == s || w < 0)
+            return -1;
+        total += w;
+        cumulative[n++] = total;
+        s = *end == ',' ? end + 1 : end;
+        if (end == s && *s)
+            return -1;
+    }
+    if (*s || n == 0 || total <= 0)
+        return -1;
+    for (i = 0; i < n; i++)
+        cumulative[i] /= total;
+    return n;
+}
+
+static int pick_priority(const double *cumulative, int n, uint64_t *state) {
+    double u = rng_uniform(state);
+    int i;
+
+    for (i = 0; i < n - 1; i++)
+        if (u <= cumulative[i])
+            break;
+    return i + 1;
+}
+
+// a burst of at least one unit
+static int to_burst(double x) {
+    if (x >= INT_MAX)
+        return INT_MAX;
+    return x < 1 ? 1 : (int)ceil(x);
+}
+
+// the next I/O burst and the CPU burst after it
+static void next_io(const struct dist *io, const struct dist *cpu, int devices, uint64_t *state,
+                    struct sched_io *b) {
+    b->device = devices > 1 ? rng_next(state) % devices : 0;
+    b->io = to_burst(sample(io, state));
+    b->cpu = to_burst(sample(cpu, state));
+}
+
+static int digits(uint64_t v) {
+    int n = 1;
+
+    while (v >= 10) {
+        v /= 10;
+        n++;
+    }
+    return n;
+}
+
+static void put(const void *p, size_t size, FILE *out) {
+    if (fwrite(p, size, 1, out) != 1) {
+        perror("gen");
+        exit(EXIT_FAILURE);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    struct dist burst = { DIST_EXP, 20, 0, 0 };
+    struct dist arrival = { DIST_NONE, 0, 0, 0 };
+    struct dist io = { DIST_NONE, 0, 0, 0 };
+    struct sched_io b;
+    int nio = 1, devices = 1, j;
+    double mix[MAX_PRIORITY_CLASSES];
+    int nmix = parse_mix("uniform", mix);
+    long long count = 10, i;
+    long long now = 0;
+    uint64_t seed = 1, rng, io_rng;
+    int binary = 0;
+    const char *path = NULL;
+    FILE *out = stdout;
+    char name[16];
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--count=", 8) == 0) {
+            count = atoll(argv[i] + 8);
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            seed = strtoull(argv[i] + 7, NULL, 0);
+        } else if (strncmp(argv[i], "--burst=", 8) == 0) {
+            if (parse_dist(argv[i] + 8, &burst) == -1 || burst.kind == DIST_NONE)
+                usage(argv[0]);
+        } else if (strncmp(argv[i], "--arrival=", 10) == 0) {
+            if (parse_dist(argv[i] + 10, &arrival) == -1)
+                usage(argv[0]);
+        } else if (strncmp(argv[i], "--priorities=", 13) == 0) {
+            if ((nmix = parse_mix(argv[i] + 13, mix)) == -1)
+                usage(argv[0]);
+        } else if (strncmp(argv[i], "--io=", 5) == 0) {
+            if (parse_dist(argv[i] + 5, &io) == -1)
+                usage(argv[0]);
+        } else if (strncmp(argv[i], "--io-bursts=", 12) == 0) {
+            nio = atoi(argv[i] + 12);
+        } else if (strncmp(argv[i], "--devices=", 10) == 0) {
+            devices = atoi(argv[i] + 10);
+        } else if (strcmp(argv[i], "--format=text") == 0) {
+            binary = 0;
+        } else if (strcmp(argv[i], "--format=binary") == 0) {
+            binary = 1;
+        } else if (strncmp(argv[i], "--out=", 6) == 0) {
+            path = argv[i] + 6;
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (count < 0 || count > INT_MAX || nio < 0 || devices < 1 || devices > MAX_DEVICES)
+        usage(argv[0]);
+    if (io.kind == DIST_NONE)
+        nio = 0;
+    if (nio > 0 && count > UINT32_MAX / nio) {
+        fprintf(stderr, "%s: too many I/O bursts for a .sched I/O table\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    if (path && !(out = fopen(path, binary ? "wb" : "w"))) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    setvbuf(out, NULL, _IOFBF, OUT_BUFFER);
+    rng = seed;
+    io_rng = seed + IO_STREAM;
+
+    struct sched_header header;
+    uint32_t name_offset = 0;
+    if (binary) {
+        // names are T1, T2, ...; size the string table up front so the
+        // header can be written before any record
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, SCHED_MAGIC, sizeof(header.magic));
+        header.version = SCHED_VERSION;
+        header.record_size = sizeof(struct sched_record);
+        header.count = count;
+        header.names_offset = sizeof(header) + count * sizeof(struct sched_record);
+        for (i = 1; i <= count; i++)
+            header.names_size += 1 + digits(i) + 1;
+        put(&header, sizeof(header), out);
+    }
+
+    for (i = 0; i < count; i++) {
+        int priority = pick_priority(mix, nmix, &rng);
+        int cpu = to_burst(sample(&burst, &rng));
+
+        if (i > 0 && arrival.kind != DIST_NONE) {
+            now += (long long)sample(&arrival, &rng);
+            if (now > INT_MAX) {
+                fprintf(stderr, "%s: arrival times overflow after %lld tasks\n", argv[0], i);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        if (binary) {
+            struct sched_record rec;
+            rec.tid = i;
+            rec.priority = priority;
+            rec.burst = cpu;
+            rec.arrival = now;
+            rec.name = name_offset;
+            rec.deadline = 0;
+            rec.period = 0;
+            rec.io = i * nio;
+            rec.nio = nio;
+            put(&rec, sizeof(rec), out);
+            name_offset += 1 + digits(i + 1) + 1;
+            continue;
+        }
+
+        fprintf(out, "T%lld, %d, %d", i + 1, priority, cpu);
+        for (j = 0; j < nio; j++) {
+            next_io(&io, &burst, devices, &io_rng, &b);
+            if (b.device > 0)
+                fprintf(out, "/%d@%d/%d", b.io, b.device, b.cpu);
+            else
+                fprintf(out, "/%d/%d", b.io, b.cpu);
+        }
+        if (arrival.kind != DIST_NONE)
+            fprintf(out, ", %lld\n", now);
+        else
+            fprintf(out, "\n");
+    }
+
+    if (binary) {
+        for (i = 1; i <= count; i++) {
+            int n = snprintf(name, sizeof(name), "T%lld", i);
+            put(name, n + 1, out);
+        }
+
+        // the I/O table, from the same stream as the text bursts
+        if (nio > 0 && (header.names_offset + header.names_size) % 4)
+            put("\0\0\0", 4 - (header.names_offset + header.names_size) % 4, out);
+        for (i = 0; i < count * nio; i++) {
+            next_io(&io, &burst, devices, &io_rng, &b);
+            put(&b, sizeof(b), out);
+        }
+    }
+
+    if (fclose(out) == EOF) {
+        perror("gen");
+        exit(EXIT_FAILURE);
+    }
+    return 0;
+}
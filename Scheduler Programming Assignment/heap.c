@@ -0,0 +1,170 @@
+/**
+ * Binary heap operations
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
+
+#include "heap.h"
+#include "task.h"
+
+#define INITIAL_CAPACITY 64
+
+void heap_init(struct heap *heap, task_cmp cmp) {
+    heap->tasks = NULL;
+    heap->size = 0;
+    heap->capacity = 0;
+    heap->cmp = cmp;
+}
+
+// move the task at index i up until its parent orders before it
+static void sift_up(struct heap *heap, int i) {
+    Task *task = heap->tasks[i];
+
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (heap->cmp(heap->tasks[parent], task) <= 0)
+            break;
+        heap->tasks[i] = heap->tasks[parent];
+        i = parent;
+    }
+    heap->tasks[i] = task;
+}
+
+// move the task at index i down until both children order after it
+static void sift_down(struct heap *heap, int i) {
+    Task *task = heap->tasks[i];
+
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= heap->size)
+            break;
+        if (child + 1 < heap->size && heap->cmp(heap->tasks[child + 1], heap->tasks[child]) < 0)
+            child++;
+        if (heap->cmp(task, heap->tasks[child]) <= 0)
+            break;
+        heap->tasks[i] = heap->tasks[child];
+        i = child;
+    }
+    heap->tasks[i] = task;
+}
+
+// add a task to the ready queue
+void heap_push(struct heap *heap, Task *task) {
+    if (heap->size == heap->capacity) {
+        int capacity = heap->capacity ? heap->capacity * 2 : INITIAL_CAPACITY;
+        Task **tasks = realloc(heap->tasks, capacity * sizeof(Task *));
+        if (!tasks) {
+            fprintf(stderr, "realloc failed in heap_push()\n");
+            exit(EXIT_FAILURE);
+        }
+        heap->tasks = tasks;
+        heap->capacity = capacity;
+    }
+
+    heap->tasks[heap->size] = task;
+    sift_up(heap, heap->size);
+    heap->size++;
+}
+
+// the task that would be picked next, or NULL if the queue is empty
+Task *heap_peek(struct heap *heap) {
+    return heap->size > 0 ? heap->tasks[0] : NULL;
+}
+
+// remove and return the task that should run next
+Task *heap_pop(struct heap *heap) {
+    if (heap->size == 0)
+        return NULL;
+
+    Task *top = heap->tasks[0];
+    heap->size--;
+    if (heap->size > 0) {
+        heap->tasks[0] = heap->tasks[heap->size];
+        sift_down(heap, 0);
+    }
+    return top;
+}
+
+// remove and return an arbitrary leaf in O(1), e.g. to migrate it
+Task *heap_remove_last(struct heap *heap) {
+    if (heap->size == 0)
+        return NULL;
+    return heap->tasks[--heap->size];
+}
+
+void heap_free(struct heap *heap) {
+    free(heap->tasks);
+    heap_init(heap, heap->cmp);
+}
+
+/**
+ * The list-based schedulers inserted at the head and picked the first
+ * best match, so among equal keys the most recently added task ran first.
+ * Breaking ties on the higher tid keeps that order.
+ */
+static int cmp_tid(const Task *a, const Task *b) {
+    return (b->tid > a->tid) - (b->tid < a->tid);
+}
+
+// shortest burst first
+int cmp_burst(const Task *a, const Task *b) {
+    if (a->burst != b->burst)
+        return a->burst < b->burst ? -1 : 1;
+    return cmp_tid(a, b);
+}
+
+// highest priority first
+int cmp_priority(const Task *a, const Task *b) {
+    if (a->priority != b->priority)
+        return a->priority > b->priority ? -1 : 1;
+    return cmp_tid(a, b);
+}
+
+// lowest stride pass first; stride keeps it in vruntime
+int cmp_pass(const Task *a, const Task *b) {
+    if (a->vruntime != b->vruntime)
+        return a->vruntime < b->vruntime ? -1 : 1;
+    return cmp_tid(a, b);
+}
+
+// shortest predicted burst first
+int cmp_estimate(const Task *a, const Task *b) {
+    if (a->estimate != b->estimate)
+        return a->estimate < b->estimate ? -1 : 1;
+    return cmp_tid(a, b);
+}
+
+// absolute deadline
+long long task_due(const Task *task) {
+    return task->deadline > 0 ? (long long)task->arrival + task->deadline : LLONG_MAX;
+}
+
+// period, or for a task that only has a deadline, the deadline
+int task_rate_key(const Task *task) {
+    if (task->period > 0)
+        return task->period;
+    return task->deadline > 0 ? task->deadline : INT_MAX;
+}
+
+// earliest absolute deadline first
+int cmp_deadline(const Task *a, const Task *b) {
+    long long da = task_due(a), db = task_due(b);
+
+    if (da != db)
+        return da < db ? -1 : 1;
+    return cmp_tid(a, b);
+}
+
+// shortest period first, then earliest released, so a periodic task's
+// overrunning jobs run in order
+int cmp_period(const Task *a, const Task *b) {
+    int pa = task_rate_key(a), pb = task_rate_key(b);
+
+    if (pa != pb)
+        return pa < pb ? -1 : 1;
+    if (a->arrival != b->arrival)
+        return a->arrival < b->arrival ? -1 : 1;
+    return cmp_tid(a, b);
+}
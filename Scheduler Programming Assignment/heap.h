@@ -0,0 +1,38 @@
+/**
+ * Binary min-heap of tasks, used as the ready queue by the schedulers
+ * that always pick the "best" task (SJF, Priority, Stride, EDF, ...).
+ */
+
+#ifndef HEAP_H
+#define HEAP_H
+
+#include "task.h"
+
+struct heap {
+    Task **tasks;
+    int size;
+    int capacity;
+    task_cmp cmp;
+};
+
+// ready queue operations; push and pop are O(log n), peek is O(1)
+void heap_init(struct heap *heap, task_cmp cmp);
+void heap_push(struct heap *heap, Task *task);
+Task *heap_peek(struct heap *heap);
+Task *heap_pop(struct heap *heap);
+Task *heap_remove_last(struct heap *heap);
+void heap_free(struct heap *heap);
+
+// comparators; ties go to the task added last (highest tid)
+int cmp_burst(const Task *a, const Task *b);
+int cmp_priority(const Task *a, const Task *b);
+int cmp_pass(const Task *a, const Task *b);
+int cmp_estimate(const Task *a, const Task *b);
+int cmp_deadline(const Task *a, const Task *b);
+int cmp_period(const Task *a, const Task *b);
+
+// the keys of the last two; tasks without one order after all others
+long long task_due(const Task *task);
+int task_rate_key(const Task *task);
+
+#endif
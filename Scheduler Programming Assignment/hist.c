@@ -0,0 +1,104 @@
+/**
+ * Log-bucketed latency histogram
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "hist.h"
+
+// buckets are numbered across rows, HIST_ROW to a row
+static int bucket_of(long long value) {
+    int shift;
+
+    if (value < HIST_SUB)
+        return value;
+
+    // keep the top HIST_SUB_BITS bits of the value
+    shift = 63 - __builtin_clzll(value) - (HIST_SUB_BITS - 1);
+    return shift * HIST_ROW + (int)(value >> shift);
+}
+
+// the largest value that falls into bucket i
+static long long bucket_top(int i) {
+    int shift;
+
+    if (i < HIST_SUB)
+        return i;
+
+    shift = i / HIST_ROW - 1;
+    return ((long long)(i - shift * HIST_ROW) << shift) + (1LL << shift) - 1;
+}
+
+void hist_init(struct hist *hist) {
+    int r;
+
+    for (r = 0; r < HIST_ROWS; r++)
+        hist->rows[r] = NULL;
+    hist->count = 0;
+    hist->sum = 0;
+    hist->min = 0;
+    hist->max = 0;
+}
+
+void hist_free(struct hist *hist) {
+    int r;
+
+    for (r = 0; r < HIST_ROWS; r++) {
+        free(hist->rows[r]);
+        hist->rows[r] = NULL;
+    }
+}
+
+void hist_record(struct hist *hist, long long value) {
+    int i, r;
+
+    if (value < 0)
+        value = 0;
+
+    i = bucket_of(value);
+    r = i / HIST_ROW;
+    if (!hist->rows[r]) {
+        hist->rows[r] = calloc(HIST_ROW, sizeof(long long));
+        if (!hist->rows[r]) {
+            fprintf(stderr, "calloc failed in hist_record()\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    hist->rows[r][i % HIST_ROW]++;
+    if (hist->count == 0 || value < hist->min)
+        hist->min = value;
+    if (value > hist->max)
+        hist->max = value;
+    hist->count++;
+    hist->sum += value;
+}
+
+long long hist_percentile(const struct hist *hist, double p) {
+    long long rank, seen = 0;
+    int r, i;
+
+    if (hist->count == 0)
+        return 0;
+
+    // the rank'th smallest value, counting from 1 (nearest rank)
+    rank = (long long)ceil(p / 100.0 * hist->count - 1e-9);
+    if (rank < 1)
+        rank = 1;
+    if (rank > hist->count)
+        rank = hist->count;
+
+    for (r = 0; r < HIST_ROWS; r++) {
+        if (!hist->rows[r])
+            continue;
+        for (i = 0; i < HIST_ROW; i++) {
+            seen += hist->rows[r][i];
+            if (seen >= rank) {
+                long long top = bucket_top(r * HIST_ROW + i);
+                return top < hist->max ? top : hist->max;
+            }
+        }
+    }
+    return hist->max;
+}
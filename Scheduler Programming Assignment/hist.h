@@ -0,0 +1,41 @@
+/**
+ * Log-bucketed latency histogram in the style of HdrHistogram.
+ *
+ * Values below HIST_SUB are counted exactly. Above that, every power of
+ * two is split into HIST_SUB / 2 equal buckets, so a value is reported
+ * to within 1 part in HIST_SUB / 2 of itself however large it is.
+ * Recording is a bit scan and an increment. Count, sum, min and max are
+ * kept exactly in 64-bit integers.
+ *
+ * The counts of each power of two are allocated the first time a value
+ * of that magnitude is recorded, so an empty histogram costs nothing
+ * and a typical one only a few kilobytes.
+ */
+
+#ifndef HIST_H
+#define HIST_H
+
+#define HIST_SUB_BITS 9
+#define HIST_SUB (1 << HIST_SUB_BITS)
+#define HIST_ROW (HIST_SUB / 2)
+#define HIST_ROWS (64 - HIST_SUB_BITS + 2)
+
+struct hist {
+    long long *rows[HIST_ROWS];     // HIST_ROW counts each, or NULL
+    long long count;
+    long long sum;
+    long long min;
+    long long max;
+};
+
+void hist_init(struct hist *hist);
+void hist_free(struct hist *hist);
+
+// record one value; negative values count as 0
+void hist_record(struct hist *hist, long long value);
+
+// the value at or below which p percent of the recorded values lie,
+// 0 if nothing was recorded
+long long hist_percentile(const struct hist *hist, double p);
+
+#endif
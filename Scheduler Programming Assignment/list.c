@@ -4,52 +4,121 @@
  
 #include <stdlib.h>
 #include <stdio.h>
-#include <string.h>
+#include <limits.h>
 
 #include "list.h"
 #include "task.h"
 
 
-// add a new task to the list of tasks
-void insert(struct node **head, Task *newTask) {
-    // add the new task to the list 
-    struct node *newNode = malloc(sizeof(struct node));
+// add a new task at the head of the list
+void insert(struct list *list, Task *newTask) {
+    newTask->prev = NULL;
+    newTask->next = list->head;
+    if (list->head)
+        list->head->prev = newTask;
+    else
+        list->tail = newTask;
+    list->head = newTask;
+    list->count++;
+}
 
-    newNode->task = newTask;
-    newNode->next = *head;
-    *head = newNode;
+// add a new task at the tail of the list
+void append(struct list *list, Task *newTask) {
+    newTask->next = NULL;
+    newTask->prev = list->tail;
+    if (list->tail)
+        list->tail->next = newTask;
+    else
+        list->head = newTask;
+    list->tail = newTask;
+    list->count++;
 }
 
-// delete the selected task from the list
-void delete(struct node **head, Task *task) {
-    struct node *temp;
-    struct node *prev;
+// unlink the given task, which must be on this list
+void delete(struct list *list, Task *task) {
+    if (list->count == 0)
+        return;
 
-    temp = *head;
-    // special case - beginning of list
-    if (strcmp(task->name,temp->task->name) == 0) {
-        *head = (*head)->next;
-    }
-    else {
-        // interior or last element in the list
-        prev = *head;
-        temp = temp->next;
-        while (strcmp(task->name,temp->task->name) != 0) {
-            prev = temp;
-            temp = temp->next;
-        }
+    if (task->prev)
+        task->prev->next = task->next;
+    else
+        list->head = task->next;
 
-        prev->next = temp->next;
-    }
+    if (task->next)
+        task->next->prev = task->prev;
+    else
+        list->tail = task->prev;
+
+    task->next = NULL;
+    task->prev = NULL;
+    list->count--;
+}
+
+// remove and return the task at the head, NULL if the list is empty
+Task *dequeue(struct list *list) {
+    Task *task = list->head;
+
+    if (task)
+        delete(list, task);
+    return task;
+}
+
+// remove and return the task at the tail, the one queued most recently;
+// as a task to migrate, it has the longest wait ahead of it
+Task *list_steal(struct list *list) {
+    Task *task = list->tail;
+
+    if (task)
+        delete(list, task);
+    return task;
 }
 
 // traverse the list
-void traverse(struct node *head) {
-    struct node *temp;
-    temp = head;
+void traverse(struct list *list) {
+    Task *temp;
+    temp = list->head;
 
     while (temp != NULL) {
-        printf("[%s] [%d] [%d]\n",temp->task->name, temp->task->priority, temp->task->burst);
+        printf("[%s] [%d] [%d]\n",temp->name, temp->priority, temp->burst);
         temp = temp->next;
     }
-}
\ No newline at end of file
+}
+
+/*
+ * Round-robin fast-forward. The tasks on the list take turns, in list
+ * order, running quantum units each. Apply at once as many whole rounds
+ * as end without any task completing and within max_time, and return
+ * the time they take; *tasks is set to the number of tasks in a round.
+ * After k rounds the order is unchanged and every
+ * burst is k * quantum shorter. Nothing is skipped while a task on the
+ * list has yet to run, as its response time depends on its turn.
+ */
+long long list_skip_rounds(struct list *list, int quantum, long long max_time, int *tasks) {
+    long long round = (long long)list->count * quantum;
+    int min_burst = INT_MAX;
+    long long k;
+    Task *task;
+
+    if (list->count == 0 || quantum <= 0)
+        return 0;
+
+    for (task = list->head; task; task = task->next) {
+        if (!task->has_been_run)
+            return 0;
+        if (task->burst < min_burst)
+            min_burst = task->burst;
+    }
+
+    // the shortest task must still have more than a quantum left when
+    // its last skipped turn comes round
+    k = (min_burst - 1) / quantum;
+    if (k > max_time / round)
+        k = max_time / round;
+    if (k <= 0)
+        return 0;
+
+    for (task = list->head; task; task = task->next)
+        task->burst -= k * quantum;
+    *tasks = list->count;
+    return k * round;
+}
@@ -1,15 +1,32 @@
 /**
  * list data structure containing the tasks in the system
+ *
+ * The list is intrusive: the links live in Task itself, so a task can
+ * be on at most one list at a time and needs no separate node.
  */
 
+#ifndef LIST_H
+#define LIST_H
+
 #include "task.h"
 
-struct node {
-    Task *task;
-    struct node *next;
+struct list {
+    Task *head;
+    Task *tail;
+    int count;
 };
 
-// insert and delete operations.
-void insert(struct node **head, Task *task);
-void delete(struct node **head, Task *task);
-void traverse(struct node *head);
\ No newline at end of file
+#define LIST_INIT { NULL, NULL, 0 }
+
+// insert, append, delete, dequeue and list_steal are O(1).
+void insert(struct list *list, Task *task);
+void append(struct list *list, Task *task);
+void delete(struct list *list, Task *task);
+Task *dequeue(struct list *list);
+Task *list_steal(struct list *list);
+void traverse(struct list *list);
+
+// run whole round-robin rounds at once; see list.c
+long long list_skip_rounds(struct list *list, int quantum, long long max_time, int *tasks);
+
+#endif
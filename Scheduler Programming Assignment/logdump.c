@@ -0,0 +1,127 @@
+/**
+ * Decoder for binary dispatch logs written with --trace=binary.
+ *
+ * Usage: ./logdump <schedule file> <log file>
+ *
+ * The log only holds task ids, so it is decoded against the schedule it
+ * was recorded from; task ids are positions in that file. The output is
+ * what the scheduler prints with --trace=text, minus the header and the
+ * metrics.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "task.h"
+#include "cpu.h"
+#include "trace.h"
+#include "workload.h"
+
+int main(int argc, char *argv[])
+{
+    struct workload workload;
+    struct trace trace;
+    struct log_header *header;
+    struct log_record *rec, *end;
+    struct stat st;
+    Task *tasks;
+    char *data;
+    int fd;
+    int i;
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <schedule file> <log file>\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    if (trace_open(&trace, argv[1]) == -1)
+        exit(EXIT_FAILURE);
+    workload_init(&workload);
+    if (trace_load(&trace, workload_add, &workload) > 0)
+        exit(EXIT_FAILURE);
+
+    tasks = calloc(workload.count ? workload.count : 1, sizeof(Task));
+    if (!tasks) {
+        fprintf(stderr, "calloc failed in main()\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < workload.count; i++)
+        task_init(&tasks[i], i, &workload.specs[i], workload_io(&workload, &workload.specs[i]));
+
+    fd = open(argv[2], O_RDONLY);
+    if (fd == -1 || fstat(fd, &st) == -1) {
+        fprintf(stderr, "%s: %s\n", argv[2], strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    if ((size_t)st.st_size < sizeof(struct log_header) ||
+        (st.st_size - sizeof(struct log_header)) % sizeof(struct log_record) != 0) {
+        fprintf(stderr, "%s: not a dispatch log\n", argv[2]);
+        exit(EXIT_FAILURE);
+    }
+    data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "%s: %s\n", argv[2], strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+    madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+    header = (struct log_header *)data;
+    if (memcmp(header->magic, LOG_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version < 1 || header->version > LOG_VERSION) {
+        fprintf(stderr, "%s: not a dispatch log\n", argv[2]);
+        exit(EXIT_FAILURE);
+    }
+
+    // replay the dispatches, tracking each task's remaining burst; a task
+    // given a slice with its burst used up is back from I/O (one preempted
+    // right as its burst ended is dispatched again for 0 units first), or
+    // past its last burst is the next job of a periodic task, which keeps
+    // the task's id; jobs of one task are assumed not to overlap
+    rec = (struct log_record *)(header + 1);
+    end = (struct log_record *)(data + st.st_size);
+    for (; rec < end; rec++) {
+        Task *task;
+
+        if (rec->tid < 0 || rec->tid >= workload.count) {
+            fprintf(stderr, "%s: task id %d is not in %s\n", argv[2], rec->tid, argv[1]);
+            exit(EXIT_FAILURE);
+        }
+        task = &tasks[rec->tid];
+        // version 1 logs mark a preemption by a negative slice
+        if (header->version == 1 ? rec->slice < 0 : (rec->flags & LOG_PREEMPT) != 0) {
+            task->burst += header->version == 1 ? -rec->slice : rec->slice;
+            if (header->cpus > 1)
+                preempt_on(rec->cpu, rec->start, task);
+            else
+                preempt(task);
+            continue;
+        }
+        if (task->burst == 0 && rec->slice > 0) {
+            if (task->next_io < task->nio) {
+                task->burst = task->io[task->next_io++].cpu;
+            } else if (task->period > 0) {
+                task->burst = task->initial_burst;
+                task->next_io = 0;
+            }
+        }
+        if (header->cpus > 1)
+            run_on(rec->cpu, rec->start, task, rec->slice);
+        else
+            run(task, rec->slice);
+        task->burst -= rec->slice;
+    }
+
+    munmap(data, st.st_size);
+    free(tasks);
+    workload_free(&workload);
+    trace_close(&trace);
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * Online task source
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "online.h"
+#include "trace.h"
+#include "workload.h"
+
+int online_open(struct online *online, const char *path) {
+    memset(online, 0, sizeof(*online));
+    online->path = path;
+
+    if (strcmp(path, "-") == 0) {
+        online->in = stdin;
+        online->path = "<stdin>";
+    } else if (!(online->in = fopen(path, "r"))) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+void online_close(struct online *online) {
+    while (online->free_tasks) {
+        Task *task = online->free_tasks;
+        online->free_tasks = task->next;
+        free(task);
+    }
+    free(online->line);
+    io_list_free(&online->io);
+    if (online->in != stdin)
+        fclose(online->in);
+}
+
+static Task *online_next(void *arg) {
+    struct online *online = arg;
+    ssize_t len;
+
+    while ((len = getline(&online->line, &online->line_size, online->in)) != -1) {
+        const char *error;
+        char *name;
+        int priority, burst, arrival, deadline, period;
+        struct task_spec spec;
+        struct io_burst *io = NULL;
+        Task *task;
+
+        online->line_number++;
+        switch (trace_parse_line(online->line, online->line + len - (online->line[len - 1] == '\n'),
+                                 &name, &priority, &burst, &online->io, &arrival, &deadline, &period,
+                                 &error)) {
+        case 0:
+            continue;
+        case -1:
+            fprintf(stderr, "%s:%d: malformed task, %s\n", online->path, online->line_number, error);
+            online->errors++;
+            continue;
+        }
+
+        if ((task = online->free_tasks) != NULL) {
+            online->free_tasks = task->next;
+        } else if (!(task = malloc(sizeof(Task)))) {
+            fprintf(stderr, "malloc failed in online_next()\n");
+            exit(EXIT_FAILURE);
+        }
+        if (!(spec.name = strdup(name))) {
+            fprintf(stderr, "strdup failed in online_next()\n");
+            exit(EXIT_FAILURE);
+        }
+        if (online->io.count > 0) {
+            if (!(io = malloc(online->io.count * sizeof(struct io_burst)))) {
+                fprintf(stderr, "malloc failed in online_next()\n");
+                exit(EXIT_FAILURE);
+            }
+            memcpy(io, online->io.bursts, online->io.count * sizeof(struct io_burst));
+        }
+        spec.priority = priority;
+        spec.burst = burst;
+        spec.io = 0;
+        spec.nio = online->io.count;
+        spec.arrival = arrival;
+        spec.deadline = deadline;
+        spec.period = period;
+        task_init(task, online->next_tid++, &spec, io);
+        return task;
+    }
+    return NULL;
+}
+
+static void online_retire(void *arg, Task *task) {
+    struct online *online = arg;
+
+    free(task->name);
+    free((void *)task->io);
+    task->next = online->free_tasks;
+    online->free_tasks = task;
+}
+
+void online_source(struct online *online, struct task_source *source) {
+    source->next = online_next;
+    source->retire = online_retire;
+    source->arg = online;
+    source->ordered = 1;
+}
@@ -0,0 +1,41 @@
+/**
+ * Online task source: tasks are read one line at a time from a stream
+ * (stdin or a FIFO) while the simulation runs, in the schedule file
+ * format, in order of arrival.
+ *
+ * Each task is allocated when its line is read and handed back as soon
+ * as it completes: its name and I/O bursts are freed and the task kept
+ * for reuse. Memory
+ * is thus bounded by the number of live tasks rather than the length of
+ * the stream.
+ */
+
+#ifndef ONLINE_H
+#define ONLINE_H
+
+#include <stdio.h>
+
+#include "task.h"
+#include "sim.h"
+#include "trace.h"
+
+struct online {
+    FILE *in;
+    const char *path;
+    char *line;
+    size_t line_size;
+    int line_number;
+    int next_tid;
+    int errors;             // malformed lines, reported and skipped
+    Task *free_tasks;       // retired tasks kept for reuse
+    struct io_list io;      // I/O bursts of the line just read
+};
+
+// open path for reading, "-" meaning stdin; returns -1 on error
+int online_open(struct online *online, const char *path);
+void online_close(struct online *online);
+
+// fill in source so that it reads from online
+void online_source(struct online *online, struct task_source *source);
+
+#endif
@@ -0,0 +1,34 @@
+/**
+ * Table of all scheduling policies linked into the program.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "schedulers.h"
+
+const struct policy *const policies[] = {
+    &fcfs_policy,
+    &sjf_policy,
+    &sjf_predict_policy,
+    &priority_policy,
+    &rr_policy,
+    &priority_rr_policy,
+    &srtf_policy,
+    &mlfq_policy,
+    &cfs_policy,
+    &lottery_policy,
+    &stride_policy,
+    &edf_policy,
+    &rms_policy,
+    NULL
+};
+
+const struct policy *find_policy(const char *key) {
+    int i;
+
+    for (i = 0; policies[i]; i++)
+        if (strcmp(policies[i]->key, key) == 0)
+            return policies[i];
+    return NULL;
+}
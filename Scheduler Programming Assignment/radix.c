@@ -0,0 +1,70 @@
+/**
+ * LSD radix sort
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "radix.h"
+
+#define RADIX_BITS 11
+#define RADIX (1 << RADIX_BITS)
+
+void radix_sort(uint64_t *keys, void **items, size_t n) {
+    uint64_t *key_buf;
+    void **item_buf;
+    size_t *count;
+    int shift;
+
+    if (n < 2)
+        return;
+
+    key_buf = malloc(n * sizeof(uint64_t));
+    item_buf = malloc(n * sizeof(void *));
+    count = malloc(RADIX * sizeof(size_t));
+    if (!key_buf || !item_buf || !count) {
+        fprintf(stderr, "malloc failed in radix_sort()\n");
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t *src_keys = keys, *dst_keys = key_buf;
+    void **src_items = items, **dst_items = item_buf;
+    for (shift = 0; shift < 64; shift += RADIX_BITS) {
+        size_t i, sum = 0;
+
+        memset(count, 0, RADIX * sizeof(size_t));
+        for (i = 0; i < n; i++)
+            count[(src_keys[i] >> shift) & (RADIX - 1)]++;
+
+        // every key has the same digit here: nothing to do
+        if (count[(src_keys[0] >> shift) & (RADIX - 1)] == n)
+            continue;
+
+        for (i = 0; i < RADIX; i++) {
+            size_t c = count[i];
+            count[i] = sum;
+            sum += c;
+        }
+        for (i = 0; i < n; i++) {
+            size_t j = count[(src_keys[i] >> shift) & (RADIX - 1)]++;
+            dst_keys[j] = src_keys[i];
+            dst_items[j] = src_items[i];
+        }
+
+        uint64_t *tk = src_keys;
+        src_keys = dst_keys;
+        dst_keys = tk;
+        void **ti = src_items;
+        src_items = dst_items;
+        dst_items = ti;
+    }
+
+    if (src_keys != keys) {
+        memcpy(keys, src_keys, n * sizeof(uint64_t));
+        memcpy(items, src_items, n * sizeof(void *));
+    }
+    free(key_buf);
+    free(item_buf);
+    free(count);
+}
@@ -0,0 +1,16 @@
+/**
+ * LSD radix sort of items by 64-bit keys, 11 bits per pass. Passes
+ * over digits that are the same in every key are skipped, so small
+ * keys cost as little as one or two passes.
+ */
+
+#ifndef RADIX_H
+#define RADIX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// sort items[0..n) by keys[0..n), ascending and stable, permuting both
+void radix_sort(uint64_t *keys, void **items, size_t n);
+
+#endif
@@ -0,0 +1,254 @@
+/**
+ * Red-black tree operations
+ *
+ * Absent children are NULL and count as black. The rebalancing follows
+ * the usual insert and delete fix-ups (Cormen et al., chapter 13).
+ */
+
+#include <stddef.h>
+
+#include "rbtree.h"
+#include "task.h"
+
+void rb_init(struct rbtree *tree, task_cmp cmp) {
+    tree->root = NULL;
+    tree->leftmost = NULL;
+    tree->size = 0;
+    tree->cmp = cmp;
+}
+
+static int is_red(const Task *task) {
+    return task && task->red;
+}
+
+// replace the child link of old's parent (or the root) with new
+static void replace_child(struct rbtree *tree, Task *old, Task *new) {
+    Task *parent = old->parent;
+
+    if (!parent)
+        tree->root = new;
+    else if (parent->left == old)
+        parent->left = new;
+    else
+        parent->right = new;
+    if (new)
+        new->parent = parent;
+}
+
+static void rotate_left(struct rbtree *tree, Task *x) {
+    Task *y = x->right;
+
+    x->right = y->left;
+    if (y->left)
+        y->left->parent = x;
+    replace_child(tree, x, y);
+    y->left = x;
+    x->parent = y;
+}
+
+static void rotate_right(struct rbtree *tree, Task *x) {
+    Task *y = x->left;
+
+    x->left = y->right;
+    if (y->right)
+        y->right->parent = x;
+    replace_child(tree, x, y);
+    y->right = x;
+    x->parent = y;
+}
+
+static Task *minimum(Task *task) {
+    while (task->left)
+        task = task->left;
+    return task;
+}
+
+// restore the red-black properties after inserting the red task
+static void insert_fixup(struct rbtree *tree, Task *task) {
+    Task *parent;
+
+    while ((parent = task->parent) && parent->red) {
+        Task *grandparent = parent->parent;
+
+        if (parent == grandparent->left) {
+            Task *uncle = grandparent->right;
+            if (is_red(uncle)) {
+                parent->red = 0;
+                uncle->red = 0;
+                grandparent->red = 1;
+                task = grandparent;
+                continue;
+            }
+            if (task == parent->right) {
+                rotate_left(tree, parent);
+                task = parent;
+                parent = task->parent;
+            }
+            parent->red = 0;
+            grandparent->red = 1;
+            rotate_right(tree, grandparent);
+        } else {
+            Task *uncle = grandparent->left;
+            if (is_red(uncle)) {
+                parent->red = 0;
+                uncle->red = 0;
+                grandparent->red = 1;
+                task = grandparent;
+                continue;
+            }
+            if (task == parent->left) {
+                rotate_right(tree, parent);
+                task = parent;
+                parent = task->parent;
+            }
+            parent->red = 0;
+            grandparent->red = 1;
+            rotate_left(tree, grandparent);
+        }
+    }
+    tree->root->red = 0;
+}
+
+// add a task; it goes after any tasks that compare equal to it
+void rb_insert(struct rbtree *tree, Task *task) {
+    Task **link = &tree->root;
+    Task *parent = NULL;
+    int leftmost = 1;
+
+    while (*link) {
+        parent = *link;
+        if (tree->cmp(task, parent) < 0) {
+            link = &parent->left;
+        } else {
+            link = &parent->right;
+            leftmost = 0;
+        }
+    }
+
+    task->parent = parent;
+    task->left = task->right = NULL;
+    task->red = 1;
+    *link = task;
+    if (leftmost)
+        tree->leftmost = task;
+    tree->size++;
+    insert_fixup(tree, task);
+}
+
+/*
+ * Restore the red-black properties after removing a black node, which
+ * left the path through x (possibly NULL, hence the explicit parent)
+ * one black short.
+ */
+static void erase_fixup(struct rbtree *tree, Task *x, Task *parent) {
+    while (x != tree->root && !is_red(x)) {
+        if (x == parent->left) {
+            Task *sibling = parent->right;
+            if (sibling->red) {
+                sibling->red = 0;
+                parent->red = 1;
+                rotate_left(tree, parent);
+                sibling = parent->right;
+            }
+            if (!is_red(sibling->left) && !is_red(sibling->right)) {
+                sibling->red = 1;
+                x = parent;
+                parent = x->parent;
+                continue;
+            }
+            if (!is_red(sibling->right)) {
+                sibling->left->red = 0;
+                sibling->red = 1;
+                rotate_right(tree, sibling);
+                sibling = parent->right;
+            }
+            sibling->red = parent->red;
+            parent->red = 0;
+            sibling->right->red = 0;
+            rotate_left(tree, parent);
+        } else {
+            Task *sibling = parent->left;
+            if (sibling->red) {
+                sibling->red = 0;
+                parent->red = 1;
+                rotate_right(tree, parent);
+                sibling = parent->left;
+            }
+            if (!is_red(sibling->left) && !is_red(sibling->right)) {
+                sibling->red = 1;
+                x = parent;
+                parent = x->parent;
+                continue;
+            }
+            if (!is_red(sibling->left)) {
+                sibling->right->red = 0;
+                sibling->red = 1;
+                rotate_left(tree, sibling);
+                sibling = parent->left;
+            }
+            sibling->red = parent->red;
+            parent->red = 0;
+            sibling->left->red = 0;
+            rotate_right(tree, parent);
+        }
+        x = tree->root;
+    }
+    if (x)
+        x->red = 0;
+}
+
+// remove a task that is in the tree
+void rb_erase(struct rbtree *tree, Task *task) {
+    Task *x, *parent;
+    int removed_red = task->red;
+
+    // the leftmost task has no left child, so its successor is close by
+    if (tree->leftmost == task)
+        tree->leftmost = task->right ? minimum(task->right) : task->parent;
+
+    if (!task->left) {
+        x = task->right;
+        parent = task->parent;
+        replace_child(tree, task, x);
+    } else if (!task->right) {
+        x = task->left;
+        parent = task->parent;
+        replace_child(tree, task, x);
+    } else {
+        // splice out the successor and put it in the task's place
+        Task *next = minimum(task->right);
+        removed_red = next->red;
+        x = next->right;
+        if (next->parent == task) {
+            parent = next;
+        } else {
+            parent = next->parent;
+            replace_child(tree, next, x);
+            next->right = task->right;
+            next->right->parent = next;
+        }
+        replace_child(tree, task, next);
+        next->left = task->left;
+        next->left->parent = next;
+        next->red = task->red;
+    }
+
+    task->left = task->right = task->parent = NULL;
+    tree->size--;
+    if (!removed_red)
+        erase_fixup(tree, x, parent);
+}
+
+// the task that orders first, or NULL if the tree is empty
+Task *rb_first(struct rbtree *tree) {
+    return tree->leftmost;
+}
+
+// the task that orders last, or NULL if the tree is empty
+Task *rb_last(struct rbtree *tree) {
+    Task *task = tree->root;
+
+    while (task && task->right)
+        task = task->right;
+    return task;
+}
@@ -0,0 +1,29 @@
+/**
+ * Red-black tree of tasks, used as the ready queue by the fair
+ * scheduler (CFS).
+ *
+ * Like the list, the tree is intrusive: the links and colour live in
+ * Task itself. The leftmost task is cached, so the next task to run is
+ * found in O(1).
+ */
+
+#ifndef RBTREE_H
+#define RBTREE_H
+
+#include "task.h"
+
+struct rbtree {
+    Task *root;
+    Task *leftmost;
+    int size;
+    task_cmp cmp;
+};
+
+// insert and erase are O(log n); first is O(1)
+void rb_init(struct rbtree *tree, task_cmp cmp);
+void rb_insert(struct rbtree *tree, Task *task);
+void rb_erase(struct rbtree *tree, Task *task);
+Task *rb_first(struct rbtree *tree);
+Task *rb_last(struct rbtree *tree);
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ * Priority run queue operations
+ */
+
+#include <stdlib.h>
+
+#include "runqueue.h"
+
+void rq_init(struct runqueue *rq) {
+    int i;
+
+    rq->bitmap = 0;
+    rq->nr_running = 0;
+    for (i = 0; i < PRIO_LEVELS; i++) {
+        rq->queue[i].head = NULL;
+        rq->queue[i].tail = NULL;
+        rq->queue[i].count = 0;
+    }
+}
+
+// level of a task; priorities outside [MIN_PRIORITY, MAX_PRIORITY] are clamped
+static int rq_level(Task *task) {
+    if (task->priority < MIN_PRIORITY)
+        return 0;
+    if (task->priority > MAX_PRIORITY)
+        return PRIO_LEVELS - 1;
+    return task->priority - MIN_PRIORITY;
+}
+
+// add a task at the back of its level, e.g. after its time slice expired
+void rq_enqueue(struct runqueue *rq, Task *task) {
+    int level = rq_level(task);
+
+    append(&rq->queue[level], task);
+    rq->bitmap |= 1UL << level;
+    rq->nr_running++;
+}
+
+// add a task at the front of its level
+void rq_enqueue_head(struct runqueue *rq, Task *task) {
+    int level = rq_level(task);
+
+    insert(&rq->queue[level], task);
+    rq->bitmap |= 1UL << level;
+    rq->nr_running++;
+}
+
+// remove and return the first task of the highest non-empty level
+Task *rq_dequeue(struct runqueue *rq) {
+    if (rq->bitmap == 0)
+        return NULL;
+
+    int level = (int)(sizeof(rq->bitmap) * 8 - 1) - __builtin_clzl(rq->bitmap);
+    Task *task = rq->queue[level].head;
+
+    delete(&rq->queue[level], task);
+    if (rq->queue[level].count == 0)
+        rq->bitmap &= ~(1UL << level);
+    rq->nr_running--;
+
+    return task;
+}
+
+// remove and return the last task of the lowest non-empty level
+Task *rq_steal(struct runqueue *rq) {
+    if (rq->bitmap == 0)
+        return NULL;
+
+    int level = __builtin_ctzl(rq->bitmap);
+    Task *task = rq->queue[level].tail;
+
+    delete(&rq->queue[level], task);
+    if (rq->queue[level].count == 0)
+        rq->bitmap &= ~(1UL << level);
+    rq->nr_running--;
+
+    return task;
+}
+
+// skip whole rounds of the highest level; lower levels do not run meanwhile
+long long rq_skip_rounds(struct runqueue *rq, int quantum, long long max_time, int *tasks) {
+    if (rq->bitmap == 0)
+        return 0;
+
+    int level = (int)(sizeof(rq->bitmap) * 8 - 1) - __builtin_clzl(rq->bitmap);
+    return list_skip_rounds(&rq->queue[level], quantum, max_time, tasks);
+}
@@ -0,0 +1,31 @@
+/**
+ * Per-priority run queues in the style of the Linux O(1) scheduler:
+ * one FIFO queue per priority level plus a bitmap of the non-empty
+ * levels, so finding the highest priority task is a single bit scan.
+ */
+
+#ifndef RUNQUEUE_H
+#define RUNQUEUE_H
+
+#include "list.h"
+#include "schedulers.h"
+
+#define PRIO_LEVELS (MAX_PRIORITY - MIN_PRIORITY + 1)
+
+struct runqueue {
+    unsigned long bitmap;           // bit i set when level i is non-empty
+    struct list queue[PRIO_LEVELS];
+    int nr_running;
+};
+
+// all operations are O(1)
+void rq_init(struct runqueue *rq);
+void rq_enqueue(struct runqueue *rq, Task *task);
+void rq_enqueue_head(struct runqueue *rq, Task *task);
+Task *rq_dequeue(struct runqueue *rq);
+Task *rq_steal(struct runqueue *rq);
+
+// round-robin fast-forward within the highest level, O(tasks in it)
+long long rq_skip_rounds(struct runqueue *rq, int quantum, long long max_time, int *tasks);
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * Compact binary schedule format (.sched).
+ *
+ * A file is a header, count fixed-width task records in tid order, a
+ * string table holding every task's NUL-terminated name, and a table of
+ * I/O bursts. Records refer to names by their offset in the string
+ * table and to their I/O bursts by index, so a loader can map the file
+ * and use records and names in place. The I/O table starts at the next
+ * multiple of 4 after the names and runs to the end of the file. All
+ * fields are in host (little-endian) byte order.
+ *
+ *  +--------------+----------------------+-------+----------------+
+ *  | sched_header | sched_record x count | names | sched_io x ... |
+ *  +--------------+----------------------+-------+----------------+
+ *                  ^ sizeof(header)       ^ names_offset
+ */
+
+#ifndef SCHED_FORMAT_H
+#define SCHED_FORMAT_H
+
+#include <stdint.h>
+
+#define SCHED_MAGIC   "SCHEDBIN"
+#define SCHED_VERSION 3
+
+// version 1 records end after the name, with no deadline or period;
+// version 2 records after the period, with no I/O bursts
+#define SCHED_RECORD_V1_SIZE 20
+#define SCHED_RECORD_V2_SIZE 28
+
+struct sched_header {
+    char magic[8];              // SCHED_MAGIC, not NUL-terminated
+    uint32_t version;
+    uint32_t record_size;       // sizeof(struct sched_record)
+    uint64_t count;             // number of records
+    uint64_t names_offset;      // file offset of the string table
+    uint64_t names_size;        // size of the string table in bytes
+};
+
+struct sched_record {
+    uint32_t tid;
+    int32_t priority;
+    int32_t burst;
+    int32_t arrival;
+    uint32_t name;              // offset of the name in the string table
+    int32_t deadline;           // relative to the arrival, 0 if none
+    int32_t period;             // 0 if the task is not periodic
+    uint32_t io;                // index of the first I/O burst in the I/O table
+    uint32_t nio;               // number of I/O bursts, 0 if none
+};
+
+// an I/O burst and the CPU burst after it
+struct sched_io {
+    int32_t device;
+    int32_t io;
+    int32_t cpu;
+};
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * Converter between text schedules and the binary .sched format.
+ *
+ * Usage: ./schedconv <input> <output>
+ *
+ * A text input is written out as .sched and a .sched input as text, so
+ * converting twice gives back an equivalent file. Task ids in the
+ * binary file are the tasks' positions in the input.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trace.h"
+#include "workload.h"
+#include "sched_format.h"
+
+static void put(const void *p, size_t size, FILE *out, const char *path) {
+    if (fwrite(p, size, 1, out) != 1) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void write_binary(const struct workload *workload, FILE *out, const char *path) {
+    struct sched_header header;
+    uint32_t name = 0;
+    static const char pad[3];
+    int i;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SCHED_MAGIC, sizeof(header.magic));
+    header.version = SCHED_VERSION;
+    header.record_size = sizeof(struct sched_record);
+    header.count = workload->count;
+    header.names_offset = sizeof(header) + workload->count * sizeof(struct sched_record);
+    for (i = 0; i < workload->count; i++)
+        header.names_size += strlen(workload->specs[i].name) + 1;
+    if (header.names_size > UINT32_MAX) {
+        fprintf(stderr, "%s: names do not fit in a .sched string table\n", path);
+        exit(EXIT_FAILURE);
+    }
+    put(&header, sizeof(header), out, path);
+
+    for (i = 0; i < workload->count; i++) {
+        const struct task_spec *spec = &workload->specs[i];
+        struct sched_record rec;
+
+        rec.tid = i;
+        rec.priority = spec->priority;
+        rec.burst = spec->burst;
+        rec.arrival = spec->arrival;
+        rec.name = name;
+        rec.deadline = spec->deadline;
+        rec.period = spec->period;
+        rec.io = spec->io;
+        rec.nio = spec->nio;
+        put(&rec, sizeof(rec), out, path);
+        name += strlen(spec->name) + 1;
+    }
+
+    for (i = 0; i < workload->count; i++)
+        put(workload->specs[i].name, strlen(workload->specs[i].name) + 1, out, path);
+
+    // the I/O table, after the names padded to a multiple of 4
+    if (workload->io_count > 0 && (header.names_offset + header.names_size) % 4)
+        put(pad, 4 - (header.names_offset + header.names_size) % 4, out, path);
+    for (i = 0; i < workload->io_count; i++) {
+        struct sched_io io;
+
+        io.device = workload->io[i].device;
+        io.io = workload->io[i].io;
+        io.cpu = workload->io[i].cpu;
+        put(&io, sizeof(io), out, path);
+    }
+}
+
+// the burst column: the first CPU burst, then each I/O burst and the CPU burst after it
+static void write_bursts(const struct workload *workload, const struct task_spec *spec, FILE *out) {
+    const struct io_burst *io = workload_io(workload, spec);
+    int i;
+
+    fprintf(out, "%d", spec->burst);
+    for (i = 0; i < spec->nio; i++) {
+        if (io[i].device > 0)
+            fprintf(out, "/%d@%d/%d", io[i].io, io[i].device, io[i].cpu);
+        else
+            fprintf(out, "/%d/%d", io[i].io, io[i].cpu);
+    }
+}
+
+static void write_text(const struct workload *workload, FILE *out) {
+    int i;
+
+    for (i = 0; i < workload->count; i++) {
+        const struct task_spec *spec = &workload->specs[i];
+        fprintf(out, "%s, %d, ", spec->name, spec->priority);
+        write_bursts(workload, spec, out);
+        if (spec->period > 0)
+            fprintf(out, ", %d, %d, %d\n", spec->arrival, spec->deadline, spec->period);
+        else if (spec->deadline > 0)
+            fprintf(out, ", %d, %d\n", spec->arrival, spec->deadline);
+        else if (spec->arrival > 0)
+            fprintf(out, ", %d\n", spec->arrival);
+        else
+            fprintf(out, "\n");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    struct workload workload;
+    struct trace trace;
+    FILE *out;
+    int errors;
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <input> <output>\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    if (trace_open(&trace, argv[1]) == -1)
+        exit(EXIT_FAILURE);
+    workload_init(&workload);
+    errors = trace_load(&trace, workload_add, &workload);
+    if (errors > 0) {
+        fprintf(stderr, "%s: %d malformed task%s\n", argv[1], errors, errors == 1 ? "" : "s");
+        exit(EXIT_FAILURE);
+    }
+
+    out = fopen(argv[2], "w");
+    if (!out) {
+        perror(argv[2]);
+        exit(EXIT_FAILURE);
+    }
+    setvbuf(out, NULL, _IOFBF, 1 << 20);
+
+    if (trace_is_binary(&trace))
+        write_text(&workload, out);
+    else
+        write_binary(&workload, out, argv[2]);
+
+    if (fclose(out) == EOF) {
+        perror(argv[2]);
+        exit(EXIT_FAILURE);
+    }
+    workload_free(&workload);
+    trace_close(&trace);
+    return 0;
+}
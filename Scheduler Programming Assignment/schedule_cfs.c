@@ -0,0 +1,333 @@
+/**
+* cfs.c
+*
+* Completely Fair Scheduler, modelled on the Linux one.
+*
+* Every task has a weight set by its priority and accumulates virtual
+* runtime: the CPU time it received, scaled down by its weight. The task
+* with the least virtual runtime runs next, so over time each task gets
+* CPU in proportion to its weight and no priority starves another.
+*
+* The slices of all ready tasks fit into one target latency, unless
+* that would make them shorter than the minimum granularity. A new task
+* starts at the smallest virtual runtime on its CPU, and takes the CPU
+* at once if the running task is ahead of it by more than the wakeup
+* granularity. A task back from I/O gets credit for the time it slept,
+* on whichever CPU it wakes, but lags the smallest virtual runtime by
+* at most half the target latency.
+*
+* Parameters (--params=...), all optional:
+*
+*  latency=L        target latency (default 24)
+*  granularity=G    minimum slice (default 3)
+*  wakeup=W         wakeup preemption granularity (default 4)
+*
+* Ready tasks are kept in a red-black tree ordered by virtual runtime
+* with the leftmost task cached, so picks are O(1) and inserts O(log n).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rbtree.h"
+#include "schedulers.h"
+#include "sim.h"
+
+#define CFS_CLASSES (MAX_PRIORITY - MIN_PRIORITY + 1)
+
+// the weight of a nice 0 task in Linux; priority 5 maps to nice 0
+#define NICE_0_WEIGHT 1024
+
+// virtual runtime is kept in 1/1024 units of time to limit rounding
+#define VRUNTIME_SCALE 1024
+
+// Linux's weights for nice 4 down to -5: each step is about 1.25 times
+// the CPU share of the one below
+static const int prio_to_weight[CFS_CLASSES] = {
+    423, 526, 655, 820, 1024, 1277, 1586, 1991, 2501, 3121
+};
+
+struct cfs {
+    struct rbtree tree;
+    long long load;                 // total weight of the queued tasks
+    long long min_vruntime;         // never decreases
+    int latency;
+    int granularity;
+    int wakeup;
+    int planned;                    // slice given to the running task
+
+    // per-priority statistics
+    long long tasks[CFS_CLASSES];
+    long long dispatches[CFS_CLASSES];
+    long long time[CFS_CLASSES];
+};
+
+static int prio_class(const Task *task) {
+    if (task->priority < MIN_PRIORITY)
+        return 0;
+    if (task->priority > MAX_PRIORITY)
+        return CFS_CLASSES - 1;
+    return task->priority - MIN_PRIORITY;
+}
+
+static int weight(const Task *task) {
+    return prio_to_weight[prio_class(task)];
+}
+
+// virtual runtime for running delta units of time at the task's weight
+static long long vdelta(long long delta, const Task *task) {
+    return delta * NICE_0_WEIGHT * VRUNTIME_SCALE / weight(task);
+}
+
+// ties go to the task queued first
+static int cmp_vruntime(const Task *a, const Task *b) {
+    if (a->vruntime != b->vruntime)
+        return a->vruntime < b->vruntime ? -1 : 1;
+    return 0;
+}
+
+static void bad_params(const char *params, const char *what) {
+    fprintf(stderr, "cfs: bad parameters '%s': %s\n", params, what);
+    exit(EXIT_FAILURE);
+}
+
+static void parse_params(struct cfs *rq, const char *params) {
+    const char *p = params;
+
+    rq->latency = 24;
+    rq->granularity = 3;
+    rq->wakeup = 4;
+
+    while (p && *p) {
+        if (strncmp(p, "latency=", 8) == 0)
+            rq->latency = atoi(p + 8);
+        else if (strncmp(p, "granularity=", 12) == 0)
+            rq->granularity = atoi(p + 12);
+        else if (strncmp(p, "wakeup=", 7) == 0)
+            rq->wakeup = atoi(p + 7);
+        else
+            bad_params(params, "expected latency=, granularity= or wakeup=");
+        p = strchr(p, ',');
+        if (p)
+            p++;
+    }
+
+    if (rq->latency < 1 || rq->granularity < 1)
+        bad_params(params, "latency and granularity must be positive");
+    if (rq->wakeup < 0)
+        bad_params(params, "wakeup must not be negative");
+}
+
+static void *cfs_create(const char *params) {
+    struct cfs *rq = calloc(1, sizeof(struct cfs));
+
+    if (!rq) {
+        fprintf(stderr, "calloc failed in cfs_create()\n");
+        exit(EXIT_FAILURE);
+    }
+    parse_params(rq, params);
+    rb_init(&rq->tree, cmp_vruntime);
+    return rq;
+}
+
+static void cfs_destroy(void *rq) {
+    free(rq);
+}
+
+static void push(struct cfs *rq, Task *task) {
+    rb_insert(&rq->tree, task);
+    rq->load += weight(task);
+}
+
+// charge the task for the time it ran in its last slice
+static void charge(Task *task) {
+    task->vruntime += vdelta(task->ran, task);
+    task->ran = 0;
+}
+
+/*
+ * A new task starts level with the least served task on this CPU. A
+ * task stolen from another CPU arrives with its virtual runtime
+ * relative to that CPU's minimum (see cfs_steal) and is placed the same
+ * distance ahead of this one's.
+ */
+static void cfs_enqueue(void *arg, Task *task) {
+    struct cfs *rq = arg;
+
+    if (!task->has_been_run) {
+        task->vruntime = rq->min_vruntime;
+        rq->tasks[prio_class(task)]++;
+    } else {
+        task->vruntime += rq->min_vruntime;
+    }
+    push(rq, task);
+}
+
+static void cfs_requeue(void *arg, Task *task) {
+    charge(task);
+    push(arg, task);
+}
+
+// a preempted task is charged for the part of its slice it ran
+static void cfs_preempted(void *arg, Task *task) {
+    struct cfs *rq = arg;
+
+    // the slice was cut short; only the part that ran counts
+    rq->time[prio_class(task)] -= rq->planned - task->ran;
+    charge(task);
+    push(rq, task);
+}
+
+/*
+ * A task leaving for I/O is charged for its last slice and sleeps with
+ * its virtual runtime relative to this CPU's minimum, as a stolen task
+ * does, since it may wake on another CPU whose minimum is far from this
+ * one. The minimum moves on while it sleeps, which a relative lag
+ * cannot see, so the lag is also offset by the task's I/O time so far
+ * and the wakeup takes the time of this sleep off it at the nice 0
+ * rate. The task is then placed that far from the minimum of the CPU
+ * it wakes on, but at most half the target latency behind it: a
+ * sleeper gets to run soon, and may preempt, without banking all of
+ * its sleep.
+ */
+static void cfs_block(void *arg, Task *task) {
+    struct cfs *rq = arg;
+
+    charge(task);
+    task->vruntime += task->blocked * VRUNTIME_SCALE - rq->min_vruntime;
+}
+
+static void cfs_wakeup(void *arg, Task *task) {
+    struct cfs *rq = arg;
+    long long credit = (long long)rq->latency * VRUNTIME_SCALE / 2;
+
+    // task->blocked now includes this sleep
+    task->vruntime += rq->min_vruntime - task->blocked * VRUNTIME_SCALE;
+    if (task->vruntime < rq->min_vruntime - credit)
+        task->vruntime = rq->min_vruntime - credit;
+    push(rq, task);
+}
+
+/**
+ * pickNextTask()
+ *
+ * Removes and returns the task with the least virtual runtime.
+ */
+static Task *pickNextTask(void *arg) {
+    struct cfs *rq = arg;
+    Task *task = rb_first(&rq->tree);
+
+    if (!task)
+        return NULL;
+
+    rb_erase(&rq->tree, task);
+    rq->load -= weight(task);
+    if (task->vruntime > rq->min_vruntime)
+        rq->min_vruntime = task->vruntime;
+    return task;
+}
+
+/*
+ * The task's weighted share of the scheduling period: the target
+ * latency, stretched so no task runs for less than the granularity.
+ */
+static int cfs_slice(void *arg, Task *task) {
+    struct cfs *rq = arg;
+    long long running = rq->tree.size + 1;
+    long long load = rq->load + weight(task);
+    long long period = rq->latency;
+    long long slice;
+
+    if (running * rq->granularity > period)
+        period = running * rq->granularity;
+    slice = period * weight(task) / load;
+    if (slice < rq->granularity)
+        slice = rq->granularity;
+    if (slice > task->burst)
+        slice = task->burst;
+
+    rq->planned = slice;
+    rq->dispatches[prio_class(task)]++;
+    rq->time[prio_class(task)] += slice;
+    return slice;
+}
+
+static int cfs_preempts(void *arg, const Task *arrived, const Task *running) {
+    struct cfs *rq = arg;
+    long long current = running->vruntime + vdelta(running->ran, running);
+
+    return current - arrived->vruntime > vdelta(rq->wakeup, arrived);
+}
+
+/*
+ * Migration and load balancing hooks. The task furthest ahead moves,
+ * carrying its virtual runtime relative to this CPU's minimum.
+ */
+static Task *cfs_steal(void *arg) {
+    struct cfs *rq = arg;
+    Task *task = rb_last(&rq->tree);
+
+    if (!task)
+        return NULL;
+
+    rb_erase(&rq->tree, task);
+    rq->load -= weight(task);
+    if (task->has_been_run)
+        task->vruntime -= rq->min_vruntime;
+    else
+        rq->tasks[prio_class(task)]--;
+    return task;
+}
+
+static int cfs_size(void *rq) {
+    return ((struct cfs *)rq)->tree.size;
+}
+
+// CPU time received by each priority, summed over every CPU
+static void cfs_report(void *const *rqs, int nrqs) {
+    long long total = 0;
+    int p, i;
+
+    for (i = 0; i < nrqs; i++) {
+        const struct cfs *rq = rqs[i];
+        for (p = 0; p < CFS_CLASSES; p++)
+            total += rq->time[p];
+    }
+
+    printf("\n--- CFS Weighted Shares ---\n");
+    printf("%8s %7s %9s %11s %12s %8s %10s\n", "Priority", "Weight", "Tasks", "Dispatches", "CPU Time", "Share", "Avg Slice");
+    for (p = 0; p < CFS_CLASSES; p++) {
+        long long tasks = 0, dispatches = 0, time = 0;
+        for (i = 0; i < nrqs; i++) {
+            const struct cfs *rq = rqs[i];
+            tasks += rq->tasks[p];
+            dispatches += rq->dispatches[p];
+            time += rq->time[p];
+        }
+        if (tasks == 0)
+            continue;
+        printf("%8d %7d %9lld %11lld %12lld %7.2f%% %10.2f\n", p + MIN_PRIORITY, prio_to_weight[p], tasks,
+               dispatches, time, total > 0 ? 100.0 * time / total : 0,
+               dispatches > 0 ? (double)time / dispatches : 0);
+    }
+}
+
+const struct policy cfs_policy = {
+    .key = "cfs",
+    .name = "CFS",
+    .title = "Completely Fair",
+    .quantum = 0,
+    .create = cfs_create,
+    .destroy = cfs_destroy,
+    .enqueue = cfs_enqueue,
+    .requeue = cfs_requeue,
+    .preempted = cfs_preempted,
+    .pick_next = pickNextTask,
+    .steal = cfs_steal,
+    .size = cfs_size,
+    .preempts = cfs_preempts,
+    .slice = cfs_slice,
+    .block = cfs_block,
+    .wakeup = cfs_wakeup,
+    .report = cfs_report,
+};
@@ -0,0 +1,79 @@
+/**
+* edf.c
+*
+* Earliest-Deadline-First scheduling algorithm.
+*
+* The task whose absolute deadline (arrival plus relative deadline) is
+* nearest runs, and an arriving task with an earlier deadline preempts
+* the running one. On one CPU this meets every deadline whenever any
+* policy can. Tasks without a deadline run only when no task with one
+* is ready.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "heap.h"
+#include "schedulers.h"
+#include "sim.h"
+
+/*
+ * The ready queue is a heap ordered by absolute deadline.
+ */
+static void *edf_create(const char *params) {
+    struct heap *rq = malloc(sizeof(struct heap));
+    if (!rq) {
+        fprintf(stderr, "malloc failed in edf_create()\n");
+        exit(EXIT_FAILURE);
+    }
+    heap_init(rq, cmp_deadline);
+    return rq;
+}
+
+static void edf_destroy(void *rq) {
+    heap_free(rq);
+    free(rq);
+}
+
+static void edf_enqueue(void *rq, Task *task) {
+    heap_push(rq, task);
+}
+
+/**
+ * pickNextTask()
+ *
+ * Removes and returns the task with the earliest deadline.
+ * Returns NULL once the ready queue is empty.
+ */
+static Task *pickNextTask(void *rq) {
+    return heap_pop(rq);
+}
+
+static int edf_preempts(void *rq, const Task *arrived, const Task *running) {
+    return task_due(arrived) < task_due(running);
+}
+
+/*
+ * Migration and load balancing hooks.
+ */
+static Task *edf_steal(void *rq) {
+    return heap_remove_last(rq);
+}
+
+static int edf_size(void *rq) {
+    return ((struct heap *)rq)->size;
+}
+
+const struct policy edf_policy = {
+    .key = "edf",
+    .name = "EDF",
+    .title = "Earliest-Deadline-First",
+    .quantum = 0,
+    .create = edf_create,
+    .destroy = edf_destroy,
+    .enqueue = edf_enqueue,
+    .pick_next = pickNextTask,
+    .steal = edf_steal,
+    .size = edf_size,
+    .preempts = edf_preempts,
+};
@@ -3,7 +3,7 @@
 *
 * First-Come, First-Served scheduling algorithm.
 *
-* This scheduler selects tasks in the order they were added to the list.
+* This scheduler selects tasks in the order they arrive.
 */
 
 #include <stdio.h>
@@ -11,81 +11,66 @@
 #include <string.h>
 #include "list.h"
 #include "schedulers.h"
-#include "cpu.h"
+#include "sim.h"
 
-// The head of the task list
-struct node *task_list_head = NULL;
-
-/**
- * add()
- *
- * Adds a task to the list. For FCFS, we can simply insert at the
- * beginning and reverse the list later, or insert at the end.
- * The provided list.c 'insert' function adds to the head, so our
- * list will be in reverse order of the input file. We'll correct
- * this in the 'schedule' function.
+/*
+ * The ready queue is a FIFO list: arrivals join at the tail.
  */
-void add(char *name, int priority, int burst) {
-    Task *new_task = malloc(sizeof(Task));
-    if (!new_task) {
-        fprintf(stderr, "malloc failed in add()\n");
+static void *fcfs_create(const char *params) {
+    struct list *rq = malloc(sizeof(struct list));
+    if (!rq) {
+        fprintf(stderr, "malloc failed in fcfs_create()\n");
         exit(EXIT_FAILURE);
     }
+    *rq = (struct list)LIST_INIT;
+    return rq;
+}
 
-    // strdup allocates memory for the name
-    new_task->name = strdup(name);
-    new_task->priority = priority;
-    new_task->burst = burst;
+static void fcfs_destroy(void *rq) {
+    free(rq);
+}
 
-    // Insert the new task into the list
-    insert(&task_list_head, new_task);
+static void fcfs_enqueue(void *rq, Task *task) {
+    append(rq, task);
 }
 
 /**
- * schedule()
+ * pickNextTask()
  *
- * Executes the FCFS scheduling algorithm. It processes tasks in the
- * order they appear in the input file. Since our 'insert' function
- * adds to the head of the list, the list is currently in reverse order.
- * We will traverse the list from tail to head to simulate FCFS.
- * A simple way to do this is to reverse the list first.
+ * Removes and returns the task that arrived first.
  */
-void schedule() {
-    // Reverse the list to get the correct FCFS order
-    struct node *current = task_list_head;
-    struct node *prev = NULL, *next = NULL;
-    while (current != NULL) {
-        next = current->next;
-        current->next = prev;
-        prev = current;
-        current = next;
-    }
-    task_list_head = prev;
+static Task *pickNextTask(void *rq) {
+    return dequeue(rq);
+}
 
-    // Now traverse the list in FCFS order
-    struct node *temp = task_list_head;
-    int current_time = 0;
-    int total_wait_time = 0;
-    int total_turnaround_time = 0;
-    int total_response_time = 0;
-    int task_count = 0;
+/*
+ * Migration and load balancing hooks.
+ */
+static Task *fcfs_steal(void *rq) {
+    return list_steal(rq);
+}
 
-    printf("--- FCFS Scheduling ---\n");
-    while (temp != NULL) {
-        run(temp->task, temp->task->burst);
-        
-        total_response_time += current_time;
-        total_wait_time += current_time;
-        current_time += temp->task->burst;
-        total_turnaround_time += current_time;
-        task_count++;
-        
-        temp = temp->next;
-    }
+static int fcfs_size(void *rq) {
+    return ((struct list *)rq)->count;
+}
+
+/*
+ * Everything ready at once runs in the order it was added.
+ */
+static uint64_t fcfs_run_order(const Task *task) {
+    return 0;
+}
 
-    printf("\n--- FCFS Performance Metrics ---\n");
-    // Since all tasks arrive at time 0, response time is the same as waiting time.
-    printf("Average Turnaround Time: %.2f\n", (float)total_turnaround_time / task_count);
-    printf("Average Response Time: %.2f\n", (float)total_response_time / task_count);
-    printf("Average Waiting Time: %.2f\n", (float)total_wait_time / task_count);
-}
\ No newline at end of file
+const struct policy fcfs_policy = {
+    .key = "fcfs",
+    .name = "FCFS",
+    .title = "FCFS",
+    .quantum = 0,
+    .create = fcfs_create,
+    .destroy = fcfs_destroy,
+    .enqueue = fcfs_enqueue,
+    .pick_next = pickNextTask,
+    .steal = fcfs_steal,
+    .size = fcfs_size,
+    .run_order = fcfs_run_order,
+};
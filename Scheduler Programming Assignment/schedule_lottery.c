@@ -0,0 +1,150 @@
+/**
+* lottery.c
+*
+* Lottery scheduling algorithm.
+*
+* Every task holds tickets in proportion to its priority. Each quantum
+* a ticket is drawn at random and its holder runs, so over time a task's
+* expected share of the CPU is its share of the tickets, and even the
+* lowest priority cannot starve.
+*
+* Parameters (--params=...), all optional:
+*
+*  seed=S           seed of the draws (default 1), for repeatable runs
+*
+* Tickets live in a Fenwick tree (see tickets.h), so a draw and a
+* requeue are both O(log n).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "tickets.h"
+#include "share.h"
+#include "schedulers.h"
+#include "sim.h"
+#include "cpu.h"
+
+struct lottery {
+    struct ticket_queue tickets;
+    uint64_t rng;
+    struct share share;
+};
+
+// splitmix64
+static uint64_t rng_next(struct lottery *rq) {
+    uint64_t z = (rq->rng += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static void *lottery_create(const char *params) {
+    struct lottery *rq = malloc(sizeof(struct lottery));
+    const char *p = params;
+
+    if (!rq) {
+        fprintf(stderr, "malloc failed in lottery_create()\n");
+        exit(EXIT_FAILURE);
+    }
+    tq_init(&rq->tickets);
+    share_init(&rq->share);
+    rq->rng = 1;
+
+    while (p && *p) {
+        if (strncmp(p, "seed=", 5) == 0) {
+            rq->rng = strtoull(p + 5, NULL, 10);
+        } else {
+            fprintf(stderr, "lottery: bad parameters '%s': expected seed=\n", params);
+            exit(EXIT_FAILURE);
+        }
+        p = strchr(p, ',');
+        if (p)
+            p++;
+    }
+    return rq;
+}
+
+static void lottery_destroy(void *arg) {
+    struct lottery *rq = arg;
+
+    tq_free(&rq->tickets);
+    free(rq);
+}
+
+static void lottery_enqueue(void *arg, Task *task) {
+    struct lottery *rq = arg;
+
+    tq_add(&rq->tickets, task, share_tickets(task));
+    share_add(&rq->share, task);
+}
+
+// hold a draw among every task queued and remove the winner
+static Task *draw(struct lottery *rq) {
+    if (rq->tickets.total == 0)
+        return NULL;
+    return tq_draw(&rq->tickets, rng_next(rq) % rq->tickets.total);
+}
+
+/**
+ * pickNextTask()
+ *
+ * Removes and returns the holder of a ticket drawn at random.
+ */
+static Task *pickNextTask(void *arg) {
+    struct lottery *rq = arg;
+    Task *task = draw(rq);
+
+    if (task) {
+        // the winner's tickets were in the draw, so they count for the ideal
+        share_pick(&rq->share, task);
+        share_remove(&rq->share, task);
+    }
+    return task;
+}
+
+/*
+ * Migration and load balancing hooks. A migrating task is drawn the
+ * same way, so any task is as likely to move as it is to run.
+ */
+static Task *lottery_steal(void *arg) {
+    struct lottery *rq = arg;
+    Task *task = draw(rq);
+
+    if (task)
+        share_remove(&rq->share, task);
+    return task;
+}
+
+static int lottery_size(void *rq) {
+    return ((struct lottery *)rq)->tickets.count;
+}
+
+static void lottery_report(void *const *rqs, int nrqs) {
+    const struct share **shares = malloc(nrqs * sizeof(struct share *));
+    int i;
+
+    if (!shares) {
+        fprintf(stderr, "malloc failed in lottery_report()\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < nrqs; i++)
+        shares[i] = &((struct lottery *)rqs[i])->share;
+    share_report("Lottery", shares, nrqs);
+    free(shares);
+}
+
+const struct policy lottery_policy = {
+    .key = "lottery",
+    .name = "Lottery",
+    .title = "Lottery",
+    .quantum = QUANTUM,
+    .create = lottery_create,
+    .destroy = lottery_destroy,
+    .enqueue = lottery_enqueue,
+    .pick_next = pickNextTask,
+    .steal = lottery_steal,
+    .size = lottery_size,
+    .report = lottery_report,
+};
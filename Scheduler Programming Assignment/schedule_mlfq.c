@@ -0,0 +1,355 @@
+/**
+* mlfq.c
+*
+* Multi-Level Feedback Queue scheduling algorithm.
+*
+* New tasks enter the top level. The highest non-empty level runs,
+* round-robin with that level's quantum, and an arrival preempts a task
+* running below the top. A task that has used up its allotment of CPU
+* time at a level, in one slice or many, moves down a level. A task that
+* gives up the CPU for I/O before then keeps its level, so interactive
+* tasks stay near the top. Every boost period all tasks go back to the
+* top so long jobs are not starved.
+*
+* Parameters (--params=...), all optional:
+*
+*  levels=N             number of levels (default 3, at most 16)
+*  quantum=Q0/Q1/...    quantum per level (default 10/20/40; a level not
+*                       given gets twice the one above)
+*  allotment=A0/A1/...  time at a level before demotion (default twice
+*                       the level's quantum; 0 never demotes)
+*  boost=S              boost period (default 1000; 0 never boosts)
+*
+* Ready tasks live in one FIFO per level plus a bitmap of the non-empty
+* levels, so enqueue and pick are O(1); a boost is O(tasks).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "list.h"
+#include "schedulers.h"
+#include "sim.h"
+
+#define MLFQ_MAX_LEVELS 16
+
+struct mlfq {
+    int levels;
+    int quantum[MLFQ_MAX_LEVELS];
+    int allotment[MLFQ_MAX_LEVELS];
+    long long boost;
+    struct list queue[MLFQ_MAX_LEVELS];
+    unsigned long bitmap;               // bit i set when level i is non-empty
+    int count;
+    int planned;                        // slice given to the running task
+    int planned_level;                  // and the level it was charged to
+
+    // residency statistics
+    long long dispatches[MLFQ_MAX_LEVELS];
+    long long time[MLFQ_MAX_LEVELS];    // CPU time spent at each level
+    long long demotions[MLFQ_MAX_LEVELS];
+    long long boosts;
+};
+
+static void bad_params(const char *params, const char *what) {
+    fprintf(stderr, "mlfq: bad parameters '%s': %s\n", params, what);
+    exit(EXIT_FAILURE);
+}
+
+// parse "A/B/C" into up to max ints; returns how many
+static int parse_list(const char *s, int *values, int max) {
+    char *end;
+    int n = 0;
+
+    while (n < max) {
+        long v = strtol(s, &end, 10);
+        if (end == s || v < 0)
+            return -1;
+        values[n++] = v;
+        if (*end != '/')
+            break;
+        s = end + 1;
+    }
+    return (*end == '\0' || *end == ',') ? n : -1;
+}
+
+static void parse_params(struct mlfq *rq, const char *params) {
+    int quantum[MLFQ_MAX_LEVELS], allotment[MLFQ_MAX_LEVELS];
+    int nquantum = 0, nallotment = 0;
+    const char *p = params;
+    int i;
+
+    rq->levels = 3;
+    rq->boost = 1000;
+    quantum[0] = 10;
+    nquantum = 1;
+
+    while (p && *p) {
+        if (strncmp(p, "levels=", 7) == 0) {
+            rq->levels = atoi(p + 7);
+            if (rq->levels < 1 || rq->levels > MLFQ_MAX_LEVELS)
+                bad_params(params, "levels must be 1 to 16");
+        } else if (strncmp(p, "quantum=", 8) == 0) {
+            if ((nquantum = parse_list(p + 8, quantum, MLFQ_MAX_LEVELS)) < 1)
+                bad_params(params, "quantum must be a list like 10/20/40");
+        } else if (strncmp(p, "allotment=", 10) == 0) {
+            if ((nallotment = parse_list(p + 10, allotment, MLFQ_MAX_LEVELS)) < 1)
+                bad_params(params, "allotment must be a list like 20/40/0");
+        } else if (strncmp(p, "boost=", 6) == 0) {
+            rq->boost = atoll(p + 6);
+            if (rq->boost < 0)
+                bad_params(params, "boost must not be negative");
+        } else {
+            bad_params(params, "expected levels=, quantum=, allotment= or boost=");
+        }
+        p = strchr(p, ',');
+        if (p)
+            p++;
+    }
+
+    for (i = 0; i < rq->levels; i++) {
+        rq->quantum[i] = i < nquantum ? quantum[i] : rq->quantum[i - 1] * 2;
+        if (rq->quantum[i] < 1)
+            bad_params(params, "quanta must be positive");
+        rq->allotment[i] = i < nallotment ? allotment[i] : rq->quantum[i] * 2;
+    }
+}
+
+static void *mlfq_create(const char *params) {
+    struct mlfq *rq = calloc(1, sizeof(struct mlfq));
+    int i;
+
+    if (!rq) {
+        fprintf(stderr, "calloc failed in mlfq_create()\n");
+        exit(EXIT_FAILURE);
+    }
+    parse_params(rq, params);
+    for (i = 0; i < MLFQ_MAX_LEVELS; i++)
+        rq->queue[i] = (struct list)LIST_INIT;
+    return rq;
+}
+
+static void mlfq_destroy(void *rq) {
+    free(rq);
+}
+
+static void push(struct mlfq *rq, Task *task, int at_head) {
+    if (at_head)
+        insert(&rq->queue[task->level], task);
+    else
+        append(&rq->queue[task->level], task);
+    rq->bitmap |= 1UL << task->level;
+    rq->count++;
+}
+
+// charge the task for its last slice, demoting it once its allotment
+// at this level is used up; returns whether it was demoted
+static int charge(struct mlfq *rq, Task *task) {
+    int level = task->level;
+
+    task->used += task->ran;
+    task->ran = 0;
+    if (level < rq->levels - 1 && rq->allotment[level] > 0 && task->used >= rq->allotment[level]) {
+        task->level++;
+        task->used = 0;
+        rq->demotions[level]++;
+        return 1;
+    }
+    return 0;
+}
+
+// new tasks start at the top; a task migrating from another CPU keeps its level
+static void mlfq_enqueue(void *arg, Task *task) {
+    struct mlfq *rq = arg;
+
+    if (!task->has_been_run) {
+        task->level = 0;
+        task->used = 0;
+    }
+    push(rq, task, 0);
+}
+
+// a preempted task goes back to the head of its level, unless the time
+// it ran demotes it
+static void mlfq_preempted(void *arg, Task *task) {
+    struct mlfq *rq = arg;
+
+    // the slice was cut short; only the part that ran counts, at the
+    // level it was given at even if a boost has moved the task since
+    rq->time[rq->planned_level] -= rq->planned - task->ran;
+    push(rq, task, !charge(rq, task));
+}
+
+static void mlfq_requeue(void *arg, Task *task) {
+    struct mlfq *rq = arg;
+
+    charge(rq, task);
+    push(rq, task, 0);
+}
+
+/*
+ * A task leaving for I/O has its last slice charged at its level, and
+ * comes back to the end of that level's queue, or to the top if a boost
+ * happened meanwhile. Every CPU boosts at the same time, so the count
+ * of boosts, kept in vruntime while the task is away, is the same on
+ * whichever CPU it wakes.
+ */
+static void mlfq_block(void *arg, Task *task) {
+    struct mlfq *rq = arg;
+
+    charge(rq, task);
+    task->vruntime = rq->boosts;
+}
+
+static void mlfq_wakeup(void *arg, Task *task) {
+    struct mlfq *rq = arg;
+
+    if (task->vruntime != rq->boosts) {
+        task->level = 0;
+        task->used = 0;
+    }
+    push(rq, task, 0);
+}
+
+/**
+ * pickNextTask()
+ *
+ * Removes and returns the first task of the highest non-empty level.
+ */
+static Task *pickNextTask(void *arg) {
+    struct mlfq *rq = arg;
+
+    if (rq->bitmap == 0)
+        return NULL;
+
+    int level = __builtin_ctzl(rq->bitmap);
+    Task *task = dequeue(&rq->queue[level]);
+    if (rq->queue[level].count == 0)
+        rq->bitmap &= ~(1UL << level);
+    rq->count--;
+    return task;
+}
+
+// the level's quantum, cut short where the allotment runs out first
+static int mlfq_slice(void *arg, Task *task) {
+    struct mlfq *rq = arg;
+    int level = task->level;
+    int slice = rq->quantum[level];
+
+    if (level < rq->levels - 1 && rq->allotment[level] > 0 &&
+        rq->allotment[level] - task->used < slice)
+        slice = rq->allotment[level] - task->used;
+    if (slice < 1)
+        slice = 1;
+    if (slice > task->burst)
+        slice = task->burst;
+
+    rq->planned = slice;
+    rq->planned_level = level;
+    rq->dispatches[level]++;
+    rq->time[level] += slice;
+    return slice;
+}
+
+static int mlfq_preempts(void *rq, const Task *arrived, const Task *running) {
+    return arrived->level < running->level;
+}
+
+static long long mlfq_period(void *rq) {
+    return ((struct mlfq *)rq)->boost;
+}
+
+// priority boost: every task, running or not, goes back to the top
+static void mlfq_boost(void *arg, Task *running) {
+    struct mlfq *rq = arg;
+    int level;
+    Task *task;
+
+    for (level = 1; level < rq->levels; level++) {
+        while ((task = dequeue(&rq->queue[level])) != NULL) {
+            task->level = 0;
+            task->used = 0;
+            append(&rq->queue[0], task);
+        }
+    }
+    rq->bitmap = rq->count > 0 ? 1UL : 0;
+    if (running) {
+        running->level = 0;
+        running->used = 0;
+    }
+    rq->boosts++;
+}
+
+/*
+ * Migration and load balancing hooks.
+ */
+static Task *mlfq_steal(void *arg) {
+    struct mlfq *rq = arg;
+
+    if (rq->bitmap == 0)
+        return NULL;
+
+    int level = (int)(sizeof(rq->bitmap) * 8 - 1) - __builtin_clzl(rq->bitmap);
+    Task *task = rq->queue[level].tail;
+    delete(&rq->queue[level], task);
+    if (rq->queue[level].count == 0)
+        rq->bitmap &= ~(1UL << level);
+    rq->count--;
+    return task;
+}
+
+static int mlfq_size(void *rq) {
+    return ((struct mlfq *)rq)->count;
+}
+
+// per-level residency, summed over every CPU
+static void mlfq_report(void *const *rqs, int nrqs) {
+    const struct mlfq *first = rqs[0];
+    long long total = 0, boosts = 0;
+    int level, i;
+
+    for (i = 0; i < nrqs; i++) {
+        const struct mlfq *rq = rqs[i];
+        for (level = 0; level < rq->levels; level++)
+            total += rq->time[level];
+        boosts += rq->boosts;
+    }
+
+    printf("\n--- MLFQ Level Residency ---\n");
+    printf("%5s %8s %10s %11s %12s %8s %10s\n", "Level", "Quantum", "Allotment", "Dispatches", "CPU Time", "Share", "Demotions");
+    for (level = 0; level < first->levels; level++) {
+        long long dispatches = 0, time = 0, demotions = 0;
+        for (i = 0; i < nrqs; i++) {
+            const struct mlfq *rq = rqs[i];
+            dispatches += rq->dispatches[level];
+            time += rq->time[level];
+            demotions += rq->demotions[level];
+        }
+        printf("%5d %8d %10d %11lld %12lld %7.2f%% %10lld\n", level, first->quantum[level],
+               level < first->levels - 1 ? first->allotment[level] : 0, dispatches, time,
+               total > 0 ? 100.0 * time / total : 0, demotions);
+    }
+    printf("Boosts: %lld (every %lld units)\n", boosts / nrqs, first->boost);
+}
+
+const struct policy mlfq_policy = {
+    .key = "mlfq",
+    .name = "MLFQ",
+    .title = "Multi-Level Feedback Queue",
+    .quantum = 0,
+    .create = mlfq_create,
+    .destroy = mlfq_destroy,
+    .enqueue = mlfq_enqueue,
+    .requeue = mlfq_requeue,
+    .preempted = mlfq_preempted,
+    .pick_next = pickNextTask,
+    .steal = mlfq_steal,
+    .size = mlfq_size,
+    .preempts = mlfq_preempts,
+    .slice = mlfq_slice,
+    .period = mlfq_period,
+    .periodic = mlfq_boost,
+    .block = mlfq_block,
+    .wakeup = mlfq_wakeup,
+    .report = mlfq_report,
+};
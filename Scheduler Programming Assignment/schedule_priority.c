@@ -10,89 +10,73 @@
 #include <stdlib.h>
 #include <string.h>
 #include "list.h"
+#include "heap.h"
 #include "schedulers.h"
-#include "cpu.h"
+#include "sim.h"
 
-// The head of the task list
-struct node *task_list_head = NULL;
-
-/**
- * add()
- *
- * Adds a task to the list.
+/*
+ * The ready queue is a heap ordered by priority.
  */
-void add(char *name, int priority, int burst) {
-    Task *new_task = malloc(sizeof(Task));
-    if (!new_task) {
-        fprintf(stderr, "malloc failed in add()\n");
+static void *priority_create(const char *params) {
+    struct heap *rq = malloc(sizeof(struct heap));
+    if (!rq) {
+        fprintf(stderr, "malloc failed in priority_create()\n");
         exit(EXIT_FAILURE);
     }
+    heap_init(rq, cmp_priority);
+    return rq;
+}
 
-    new_task->name = strdup(name);
-    new_task->priority = priority;
-    new_task->burst = burst;
+static void priority_destroy(void *rq) {
+    heap_free(rq);
+    free(rq);
+}
 
-    insert(&task_list_head, new_task);
+static void priority_enqueue(void *rq, Task *task) {
+    heap_push(rq, task);
 }
 
 /**
  * pickNextTask()
  *
- * Finds and returns the task with the highest priority.
+ * Removes and returns the task with the highest priority.
+ * Returns NULL once the ready queue is empty.
  */
-Task *pickNextTask() {
-    if (task_list_head == NULL) {
-        return NULL;
-    }
-
-    struct node *temp = task_list_head;
-    Task *highest_priority_task = temp->task;
-
-    while (temp != NULL) {
-        if (temp->task->priority > highest_priority_task->priority) {
-            highest_priority_task = temp->task;
-        }
-        temp = temp->next;
-    }
-
-    return highest_priority_task;
+static Task *pickNextTask(void *rq) {
+    return heap_pop(rq);
 }
 
-/**
- * schedule()
- *
- * Executes the Priority scheduling algorithm.
+/*
+ * Migration and load balancing hooks.
  */
-void schedule() {
-    int current_time = 0;
-    int total_wait_time = 0;
-    int total_turnaround_time = 0;
-    int total_response_time = 0;
-    int task_count = 0;
-
-    printf("--- Priority Scheduling ---\n");
-
-    // Count initial tasks
-    struct node *counter = task_list_head;
-    while(counter != NULL) {
-        task_count++;
-        counter = counter->next;
-    }
-
-    while (task_list_head != NULL) {
-        Task *task = pickNextTask();
-        run(task, task->burst);
+static Task *priority_steal(void *rq) {
+    return heap_remove_last(rq);
+}
 
-        total_response_time += current_time;
-        total_wait_time += current_time;
-        current_time += task->burst;
-        total_turnaround_time += current_time;
+static int priority_size(void *rq) {
+    return ((struct heap *)rq)->size;
+}
 
-        delete(&task_list_head, task);
-    }
+/*
+ * Highest priority first, ties to the higher tid as in cmp_priority().
+ * Flipping the sign bit orders ints as unsigned; inverting puts the
+ * highest first.
+ */
+static uint64_t priority_run_order(const Task *task) {
+    uint32_t rank = ~((uint32_t)task->priority ^ 0x80000000u);
+    return ((uint64_t)rank << 32) | (UINT32_MAX - (uint32_t)task->tid);
+}
 
-    printf("\n--- Priority Performance Metrics ---\n");
-    printf("Average Turnaround Time: %.2f\n", (float)total_turnaround_time / task_count);
-    printf("Average Response Time: %.2f\n", (float)total_response_time / task_count);
-    printf("Average Waiting Time: %.2f\n", (float)total_wait_time / task_count);
-}
\ No newline at end of file
+const struct policy priority_policy = {
+    .key = "priority",
+    .name = "Priority",
+    .title = "Priority",
+    .quantum = 0,
+    .create = priority_create,
+    .destroy = priority_destroy,
+    .enqueue = priority_enqueue,
+    .pick_next = pickNextTask,
+    .steal = priority_steal,
+    .size = priority_size,
+    .run_order = priority_run_order,
+};
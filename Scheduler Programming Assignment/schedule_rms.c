@@ -0,0 +1,80 @@
+/**
+* rms.c
+*
+* Rate-Monotonic scheduling algorithm.
+*
+* A fixed-priority real-time policy: the shorter a task's period, the
+* higher its priority, and an arriving task of higher priority preempts
+* the running one. A task with a deadline but no period ranks by its
+* deadline (deadline-monotonic), and tasks with neither run last.
+* Unlike EDF it can miss deadlines below full utilization; the Liu and
+* Layland bound in the deadline report says when it cannot.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "heap.h"
+#include "schedulers.h"
+#include "sim.h"
+
+/*
+ * The ready queue is a heap ordered by period.
+ */
+static void *rms_create(const char *params) {
+    struct heap *rq = malloc(sizeof(struct heap));
+    if (!rq) {
+        fprintf(stderr, "malloc failed in rms_create()\n");
+        exit(EXIT_FAILURE);
+    }
+    heap_init(rq, cmp_period);
+    return rq;
+}
+
+static void rms_destroy(void *rq) {
+    heap_free(rq);
+    free(rq);
+}
+
+static void rms_enqueue(void *rq, Task *task) {
+    heap_push(rq, task);
+}
+
+/**
+ * pickNextTask()
+ *
+ * Removes and returns the task with the shortest period.
+ * Returns NULL once the ready queue is empty.
+ */
+static Task *pickNextTask(void *rq) {
+    return heap_pop(rq);
+}
+
+static int rms_preempts(void *rq, const Task *arrived, const Task *running) {
+    return task_rate_key(arrived) < task_rate_key(running);
+}
+
+/*
+ * Migration and load balancing hooks.
+ */
+static Task *rms_steal(void *rq) {
+    return heap_remove_last(rq);
+}
+
+static int rms_size(void *rq) {
+    return ((struct heap *)rq)->size;
+}
+
+const struct policy rms_policy = {
+    .key = "rms",
+    .name = "RMS",
+    .title = "Rate-Monotonic",
+    .quantum = 0,
+    .create = rms_create,
+    .destroy = rms_destroy,
+    .enqueue = rms_enqueue,
+    .pick_next = pickNextTask,
+    .steal = rms_steal,
+    .size = rms_size,
+    .preempts = rms_preempts,
+};
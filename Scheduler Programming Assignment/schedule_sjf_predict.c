@@ -0,0 +1,163 @@
+/**
+* sjf_predict.c
+*
+* Shortest-Job-First with predicted burst lengths.
+*
+* A real scheduler does not know how long the next CPU burst will be,
+* so this variant of SJF does not look at it. It runs the task whose
+* predicted next burst is shortest, and predicts each burst as an
+* exponential average of the bursts before it:
+*
+*     estimate = alpha * last burst + (1 - alpha) * previous estimate
+*
+* With alpha near 1 the prediction follows the last burst; near 0 it
+* barely moves from the initial guess. The report compares every
+* prediction with the burst that followed it.
+*
+* Parameters (--params=...), all optional:
+*
+*  alpha=A          weight of the last burst, from 0 to 1 (default 0.5)
+*  initial=T        prediction of a task's first burst (default 10)
+*
+* The policy is non-preemptive, so a task picked runs its whole burst
+* and the burst can be measured, and the estimate updated, at the pick.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "heap.h"
+#include "schedulers.h"
+#include "sim.h"
+
+#define DEFAULT_ALPHA 0.5
+#define DEFAULT_INITIAL 10
+
+/*
+ * The ready queue is a heap ordered by the estimate.
+ */
+struct sjf_predict {
+    struct heap heap;
+    double alpha;
+    double initial;
+    long long bursts;       // bursts predicted
+    long long total;        // their total length
+    double error;           // total |estimate - burst|
+};
+
+static void *sjf_predict_create(const char *params) {
+    struct sjf_predict *rq = malloc(sizeof(struct sjf_predict));
+    const char *p = params;
+
+    if (!rq) {
+        fprintf(stderr, "malloc failed in sjf_predict_create()\n");
+        exit(EXIT_FAILURE);
+    }
+    heap_init(&rq->heap, cmp_estimate);
+    rq->alpha = DEFAULT_ALPHA;
+    rq->initial = DEFAULT_INITIAL;
+    rq->bursts = 0;
+    rq->total = 0;
+    rq->error = 0;
+
+    while (p && *p) {
+        if (strncmp(p, "alpha=", 6) == 0) {
+            rq->alpha = atof(p + 6);
+        } else if (strncmp(p, "initial=", 8) == 0) {
+            rq->initial = atof(p + 8);
+        } else {
+            fprintf(stderr, "sjf_predict: bad parameters '%s': expected alpha= or initial=\n", params);
+            exit(EXIT_FAILURE);
+        }
+        p = strchr(p, ',');
+        if (p)
+            p++;
+    }
+    if (rq->alpha < 0 || rq->alpha > 1 || rq->initial < 0) {
+        fprintf(stderr, "sjf_predict: alpha must be from 0 to 1 and initial at least 0\n");
+        exit(EXIT_FAILURE);
+    }
+    return rq;
+}
+
+static void sjf_predict_destroy(void *arg) {
+    struct sjf_predict *rq = arg;
+
+    heap_free(&rq->heap);
+    free(rq);
+}
+
+static void sjf_predict_enqueue(void *arg, Task *task) {
+    struct sjf_predict *rq = arg;
+
+    if (!task->has_been_run)
+        task->estimate = rq->initial;
+    heap_push(&rq->heap, task);
+}
+
+/**
+ * pickNextTask()
+ *
+ * Removes and returns the task with the shortest predicted burst, and
+ * folds the burst it is about to run into its estimate.
+ */
+static Task *pickNextTask(void *arg) {
+    struct sjf_predict *rq = arg;
+    Task *task = heap_pop(&rq->heap);
+
+    if (!task)
+        return NULL;
+
+    rq->bursts++;
+    rq->total += task->burst;
+    rq->error += fabs(task->estimate - task->burst);
+    task->estimate = rq->alpha * task->burst + (1 - rq->alpha) * task->estimate;
+    return task;
+}
+
+/*
+ * Migration and load balancing hooks.
+ */
+static Task *sjf_predict_steal(void *arg) {
+    return heap_remove_last(&((struct sjf_predict *)arg)->heap);
+}
+
+static int sjf_predict_size(void *rq) {
+    return ((struct sjf_predict *)rq)->heap.size;
+}
+
+static void sjf_predict_report(void *const *rqs, int nrqs) {
+    long long bursts = 0, total = 0;
+    double error = 0;
+    int i;
+
+    for (i = 0; i < nrqs; i++) {
+        const struct sjf_predict *rq = rqs[i];
+        bursts += rq->bursts;
+        total += rq->total;
+        error += rq->error;
+    }
+    if (bursts == 0)
+        return;
+
+    printf("\n--- Predictive SJF Burst Prediction (alpha = %.2f) ---\n", ((struct sjf_predict *)rqs[0])->alpha);
+    printf("Bursts: %lld\n", bursts);
+    printf("Mean Burst: %.2f\n", (double)total / bursts);
+    printf("Mean Absolute Error: %.2f (%.1f%% of the mean burst)\n", error / bursts,
+           total > 0 ? 100.0 * error / total : 0);
+}
+
+const struct policy sjf_predict_policy = {
+    .key = "sjf_predict",
+    .name = "Predictive SJF",
+    .title = "Predictive SJF",
+    .quantum = 0,
+    .create = sjf_predict_create,
+    .destroy = sjf_predict_destroy,
+    .enqueue = sjf_predict_enqueue,
+    .pick_next = pickNextTask,
+    .steal = sjf_predict_steal,
+    .size = sjf_predict_size,
+    .report = sjf_predict_report,
+};
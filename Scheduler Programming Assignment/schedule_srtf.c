@@ -0,0 +1,83 @@
+/**
+* srtf.c
+*
+* Shortest-Remaining-Time-First scheduling algorithm.
+*
+* The preemptive form of SJF: the task with the least CPU time left
+* runs, and an arriving task that needs less than what the running task
+* has left takes the CPU from it. Preemption is only checked when a
+* task arrives, the only time the shortest remaining time can change.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "list.h"
+#include "heap.h"
+#include "schedulers.h"
+#include "sim.h"
+
+/*
+ * The ready queue is a heap ordered by remaining burst.
+ */
+static void *srtf_create(const char *params) {
+    struct heap *rq = malloc(sizeof(struct heap));
+    if (!rq) {
+        fprintf(stderr, "malloc failed in srtf_create()\n");
+        exit(EXIT_FAILURE);
+    }
+    heap_init(rq, cmp_burst);
+    return rq;
+}
+
+static void srtf_destroy(void *rq) {
+    heap_free(rq);
+    free(rq);
+}
+
+static void srtf_enqueue(void *rq, Task *task) {
+    heap_push(rq, task);
+}
+
+/**
+ * pickNextTask()
+ *
+ * Removes and returns the task with the least remaining time.
+ * Returns NULL once the ready queue is empty.
+ */
+static Task *pickNextTask(void *rq) {
+    return heap_pop(rq);
+}
+
+/*
+ * Only a strictly shorter task preempts, so equal tasks do not take
+ * turns at the CPU.
+ */
+static int srtf_preempts(void *rq, const Task *arrived, const Task *running) {
+    return arrived->burst < running->burst;
+}
+
+/*
+ * Migration and load balancing hooks.
+ */
+static Task *srtf_steal(void *rq) {
+    return heap_remove_last(rq);
+}
+
+static int srtf_size(void *rq) {
+    return ((struct heap *)rq)->size;
+}
+
+const struct policy srtf_policy = {
+    .key = "srtf",
+    .name = "SRTF",
+    .title = "Shortest-Remaining-Time-First",
+    .quantum = 0,
+    .create = srtf_create,
+    .destroy = srtf_destroy,
+    .enqueue = srtf_enqueue,
+    .pick_next = pickNextTask,
+    .steal = srtf_steal,
+    .size = srtf_size,
+    .preempts = srtf_preempts,
+};
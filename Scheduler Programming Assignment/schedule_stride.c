@@ -0,0 +1,172 @@
+/**
+* stride.c
+*
+* Stride scheduling algorithm.
+*
+* The deterministic counterpart of lottery scheduling. Every task holds
+* tickets in proportion to its priority and has a stride inversely
+* proportional to them. The task with the lowest pass runs for a
+* quantum and its pass advances by its stride, so each task gets its
+* share of the tickets with an error of at most about one quantum,
+* where a lottery's error grows with the square root of the quanta.
+* A slice cut short, by the end of a burst or by I/O, advances the pass
+* only by the part of the stride it used; to keep that exact, the pass
+* grows by the stride for every unit of time run rather than per quantum.
+*
+* A new task starts one quantum past the pass of the last task picked,
+* as if it had just run, so a task with few tickets does not get its
+* first quantum ahead of its share. A task that leaves for I/O keeps
+* how far its pass is from the current one and rejoins that far away,
+* so it neither loses its place nor catches up on the time it was gone.
+*
+* The ready queue is a heap ordered by pass; the pass is kept in the
+* task's vruntime.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "heap.h"
+#include "share.h"
+#include "schedulers.h"
+#include "sim.h"
+#include "cpu.h"
+
+// divisible by every ticket count from 1 to 10, so strides are exact
+#define STRIDE1 2520
+
+struct stride {
+    struct heap heap;
+    long long pass;                 // pass of the last task picked
+    struct share share;
+};
+
+static long long stride_of(const Task *task) {
+    return STRIDE1 / share_tickets(task);
+}
+
+// advance the task's pass for the time it ran in its last slice
+static void charge(Task *task) {
+    task->vruntime += stride_of(task) * task->ran;
+    task->ran = 0;
+}
+
+static void *stride_create(const char *params) {
+    struct stride *rq = malloc(sizeof(struct stride));
+    if (!rq) {
+        fprintf(stderr, "malloc failed in stride_create()\n");
+        exit(EXIT_FAILURE);
+    }
+    heap_init(&rq->heap, cmp_pass);
+    rq->pass = 0;
+    share_init(&rq->share);
+    return rq;
+}
+
+static void stride_destroy(void *arg) {
+    struct stride *rq = arg;
+
+    heap_free(&rq->heap);
+    free(rq);
+}
+
+/*
+ * A task stolen from another CPU, or back from I/O, arrives with its
+ * pass relative to the pass of the CPU it left (see stride_steal and
+ * stride_block) and keeps the same lead or lag here.
+ */
+static void stride_enqueue(void *arg, Task *task) {
+    struct stride *rq = arg;
+
+    if (!task->has_been_run)
+        task->vruntime = rq->pass + stride_of(task) * QUANTUM;
+    else
+        task->vruntime += rq->pass;
+    heap_push(&rq->heap, task);
+    share_add(&rq->share, task);
+}
+
+static void stride_requeue(void *arg, Task *task) {
+    struct stride *rq = arg;
+
+    charge(task);
+    heap_push(&rq->heap, task);
+    share_add(&rq->share, task);
+}
+
+// a task leaving for I/O; it comes back through stride_enqueue()
+static void stride_block(void *arg, Task *task) {
+    struct stride *rq = arg;
+
+    charge(task);
+    task->vruntime -= rq->pass;
+}
+
+/**
+ * pickNextTask()
+ *
+ * Removes and returns the task with the lowest pass. Its pass advances
+ * when the slice is over, by the time it actually ran.
+ */
+static Task *pickNextTask(void *arg) {
+    struct stride *rq = arg;
+    Task *task = heap_pop(&rq->heap);
+
+    if (!task)
+        return NULL;
+
+    share_pick(&rq->share, task);
+    share_remove(&rq->share, task);
+    rq->pass = task->vruntime;
+    return task;
+}
+
+/*
+ * Migration and load balancing hooks.
+ */
+static Task *stride_steal(void *arg) {
+    struct stride *rq = arg;
+    Task *task = heap_remove_last(&rq->heap);
+
+    if (!task)
+        return NULL;
+
+    share_remove(&rq->share, task);
+    if (task->has_been_run)
+        task->vruntime -= rq->pass;
+    return task;
+}
+
+static int stride_size(void *rq) {
+    return ((struct stride *)rq)->heap.size;
+}
+
+static void stride_report(void *const *rqs, int nrqs) {
+    const struct share **shares = malloc(nrqs * sizeof(struct share *));
+    int i;
+
+    if (!shares) {
+        fprintf(stderr, "malloc failed in stride_report()\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < nrqs; i++)
+        shares[i] = &((struct stride *)rqs[i])->share;
+    share_report("Stride", shares, nrqs);
+    free(shares);
+}
+
+const struct policy stride_policy = {
+    .key = "stride",
+    .name = "Stride",
+    .title = "Stride",
+    .quantum = QUANTUM,
+    .create = stride_create,
+    .destroy = stride_destroy,
+    .enqueue = stride_enqueue,
+    .requeue = stride_requeue,
+    .pick_next = pickNextTask,
+    .steal = stride_steal,
+    .size = stride_size,
+    .block = stride_block,
+    .report = stride_report,
+};
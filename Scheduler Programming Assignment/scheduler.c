@@ -0,0 +1,81 @@
+/**
+ * Scheduler instances
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "schedulers.h"
+#include "arena.h"
+#include "list.h"
+#include "workload.h"
+
+struct scheduler {
+    const struct policy *policy;
+    struct sim_options options;
+    struct arena arena;         // tasks of the current run
+    struct list tasks;
+    int next_tid;
+};
+
+struct scheduler *scheduler_create(const struct policy *policy, const struct sim_options *options) {
+    struct scheduler *scheduler = malloc(sizeof(struct scheduler));
+    if (!scheduler) {
+        fprintf(stderr, "malloc failed in scheduler_create()\n");
+        exit(EXIT_FAILURE);
+    }
+
+    scheduler->policy = policy;
+    scheduler->options = *options;
+    scheduler->arena = (struct arena)ARENA_INIT;
+    scheduler->tasks = (struct list)LIST_INIT;
+    scheduler->next_tid = 0;
+    return scheduler;
+}
+
+void scheduler_destroy(struct scheduler *scheduler) {
+    arena_release(&scheduler->arena);
+    free(scheduler);
+}
+
+void scheduler_add(void *arg, char *name, int priority, int burst,
+                   const struct io_burst *io, int nio, int arrival, int deadline, int period) {
+    struct scheduler *scheduler = arg;
+    Task *task = arena_alloc(&scheduler->arena, sizeof(Task));
+    struct io_burst *bursts = NULL;
+    struct task_spec spec = { .name = name, .priority = priority, .burst = burst, .nio = nio,
+                              .arrival = arrival, .deadline = deadline, .period = period };
+
+    if (nio > 0) {
+        bursts = arena_alloc(&scheduler->arena, nio * sizeof(struct io_burst));
+        memcpy(bursts, io, nio * sizeof(struct io_burst));
+    }
+
+    task_init(task, scheduler->next_tid++, &spec, bursts);
+    append(&scheduler->tasks, task);
+}
+
+void scheduler_add_workload(struct scheduler *scheduler, const struct workload *workload) {
+    int i;
+
+    for (i = 0; i < workload->count; i++) {
+        const struct task_spec *spec = &workload->specs[i];
+        scheduler_add(scheduler, spec->name, spec->priority, spec->burst, workload_io(workload, spec),
+                      spec->nio, spec->arrival, spec->deadline, spec->period);
+    }
+}
+
+void scheduler_run(struct scheduler *scheduler, struct sim_result *result) {
+    simulate(scheduler->policy, &scheduler->tasks, &scheduler->options, result);
+
+    // simulate() consumed the tasks; keep the memory for the next run
+    scheduler->tasks = (struct list)LIST_INIT;
+    scheduler->next_tid = 0;
+    arena_reset(&scheduler->arena);
+}
+
+void scheduler_run_source(struct scheduler *scheduler, struct task_source *source,
+                          struct sim_result *result) {
+    simulate_source(scheduler->policy, source, &scheduler->options, result);
+}
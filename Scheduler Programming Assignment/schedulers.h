@@ -1,8 +1,57 @@
+/**
+ * Scheduling policies and scheduler instances.
+ *
+ * Every policy is linked into every binary and looked up by name at
+ * runtime. A scheduler instance pairs a policy with its own options,
+ * tasks and memory, so any number of them can exist in one process.
+ */
+
+#ifndef SCHEDULERS_H
+#define SCHEDULERS_H
+
+#include "sim.h"
+#include "workload.h"
+
 #define MIN_PRIORITY 1
 #define MAX_PRIORITY 10
 
-// add a task to the list 
-void add(char *name, int priority, int burst);
+// the scheduling policies, one per schedule_*.c
+extern const struct policy fcfs_policy;
+extern const struct policy sjf_policy;
+extern const struct policy sjf_predict_policy;
+extern const struct policy priority_policy;
+extern const struct policy rr_policy;
+extern const struct policy priority_rr_policy;
+extern const struct policy srtf_policy;
+extern const struct policy mlfq_policy;
+extern const struct policy cfs_policy;
+extern const struct policy lottery_policy;
+extern const struct policy stride_policy;
+extern const struct policy edf_policy;
+extern const struct policy rms_policy;
+
+// every policy above, NULL-terminated
+extern const struct policy *const policies[];
+
+// look a policy up by its key, e.g. "rr"; NULL if there is none
+const struct policy *find_policy(const char *key);
+
+struct scheduler;
+
+struct scheduler *scheduler_create(const struct policy *policy, const struct sim_options *options);
+void scheduler_destroy(struct scheduler *scheduler);
+
+// add a task; name must stay valid until scheduler_run() returns, io
+// is copied. Matches trace_add_fn, so a trace can be loaded straight in.
+void scheduler_add(void *scheduler, char *name, int priority, int burst,
+                   const struct io_burst *io, int nio, int arrival, int deadline, int period);
+void scheduler_add_workload(struct scheduler *scheduler, const struct workload *workload);
+
+// run the tasks added so far, then forget them
+void scheduler_run(struct scheduler *scheduler, struct sim_result *result);
+
+// run the tasks of a source instead, e.g. an online stream
+void scheduler_run_source(struct scheduler *scheduler, struct task_source *source,
+                          struct sim_result *result);
 
-// invoke the scheduler
-void schedule();
\ No newline at end of file
+#endif
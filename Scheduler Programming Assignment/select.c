@@ -0,0 +1,192 @@
+/**
+ * Argmin/argmax kernels
+ */
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "select.h"
+
+/*
+ * Scalar kernels. The vector kernels below finish their tails with these.
+ */
+static int argmin_scalar(const int32_t *v, int n) {
+    int best = n > 0 ? 0 : -1;
+    int i;
+
+    for (i = 1; i < n; i++)
+        if (v[i] < v[best])
+            best = i;
+    return best;
+}
+
+static int argmax_scalar(const int32_t *v, int n) {
+    int best = n > 0 ? 0 : -1;
+    int i;
+
+    for (i = 1; i < n; i++)
+        if (v[i] > v[best])
+            best = i;
+    return best;
+}
+
+// pick the winning lane: best value, then lowest index
+static int reduce_lanes(const int32_t *val, const int32_t *idx, int lanes, int want_max) {
+    int best = 0;
+    int i;
+
+    for (i = 1; i < lanes; i++) {
+        int better = want_max ? val[i] > val[best] : val[i] < val[best];
+        if (better || (val[i] == val[best] && idx[i] < idx[best]))
+            best = i;
+    }
+    return best;
+}
+
+// fold the scalar tail [from, n) into the vector result
+static int finish(const int32_t *v, int n, int from, int best, int want_max) {
+    int i;
+
+    for (i = from; i < n; i++)
+        if (want_max ? v[i] > v[best] : v[i] < v[best])
+            best = i;
+    return best;
+}
+
+/*
+ * SSE4.1: four lanes, each tracking its best value and where it was seen.
+ * Lanes only move on a strict improvement, so each keeps its lowest index.
+ */
+__attribute__((target("sse4.1")))
+static inline int arg_sse41(const int32_t *v, int n, int want_max) {
+    if (n < 8)
+        return want_max ? argmax_scalar(v, n) : argmin_scalar(v, n);
+
+    __m128i best = _mm_loadu_si128((const __m128i *)v);
+    __m128i best_idx = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i idx = best_idx;
+    const __m128i step = _mm_set1_epi32(4);
+    int i;
+
+    for (i = 4; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(v + i));
+        idx = _mm_add_epi32(idx, step);
+        __m128i better = want_max ? _mm_cmpgt_epi32(x, best) : _mm_cmplt_epi32(x, best);
+        best = _mm_blendv_epi8(best, x, better);
+        best_idx = _mm_blendv_epi8(best_idx, idx, better);
+    }
+
+    int32_t val[4], pos[4];
+    _mm_storeu_si128((__m128i *)val, best);
+    _mm_storeu_si128((__m128i *)pos, best_idx);
+    return finish(v, n, i, pos[reduce_lanes(val, pos, 4, want_max)], want_max);
+}
+
+__attribute__((target("sse4.1")))
+static int argmin_sse41(const int32_t *v, int n) {
+    return arg_sse41(v, n, 0);
+}
+
+__attribute__((target("sse4.1")))
+static int argmax_sse41(const int32_t *v, int n) {
+    return arg_sse41(v, n, 1);
+}
+
+/*
+ * AVX2: same scheme with eight lanes.
+ */
+__attribute__((target("avx2")))
+static inline int arg_avx2(const int32_t *v, int n, int want_max) {
+    if (n < 16)
+        return want_max ? argmax_scalar(v, n) : argmin_scalar(v, n);
+
+    __m256i best = _mm256_loadu_si256((const __m256i *)v);
+    __m256i best_idx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i idx = best_idx;
+    const __m256i step = _mm256_set1_epi32(8);
+    int i;
+
+    for (i = 8; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(v + i));
+        idx = _mm256_add_epi32(idx, step);
+        __m256i better = want_max ? _mm256_cmpgt_epi32(x, best) : _mm256_cmpgt_epi32(best, x);
+        best = _mm256_blendv_epi8(best, x, better);
+        best_idx = _mm256_blendv_epi8(best_idx, idx, better);
+    }
+
+    int32_t val[8], pos[8];
+    _mm256_storeu_si256((__m256i *)val, best);
+    _mm256_storeu_si256((__m256i *)pos, best_idx);
+    return finish(v, n, i, pos[reduce_lanes(val, pos, 8, want_max)], want_max);
+}
+
+__attribute__((target("avx2")))
+static int argmin_avx2(const int32_t *v, int n) {
+    return arg_avx2(v, n, 0);
+}
+
+__attribute__((target("avx2")))
+static int argmax_avx2(const int32_t *v, int n) {
+    return arg_avx2(v, n, 1);
+}
+
+/*
+ * Runtime dispatch. The first call resolves SELECT_AUTO.
+ */
+static int (*argmin_fn)(const int32_t *, int) = NULL;
+static int (*argmax_fn)(const int32_t *, int) = NULL;
+static const char *impl_name = "scalar";
+
+int select_use(enum select_impl impl) {
+    __builtin_cpu_init();
+
+    if (impl == SELECT_AUTO) {
+        if (__builtin_cpu_supports("avx2"))
+            impl = SELECT_AVX2;
+        else if (__builtin_cpu_supports("sse4.1"))
+            impl = SELECT_SSE41;
+        else
+            impl = SELECT_SCALAR;
+    }
+
+    switch (impl) {
+    case SELECT_AVX2:
+        if (!__builtin_cpu_supports("avx2"))
+            return -1;
+        argmin_fn = argmin_avx2;
+        argmax_fn = argmax_avx2;
+        impl_name = "avx2";
+        break;
+    case SELECT_SSE41:
+        if (!__builtin_cpu_supports("sse4.1"))
+            return -1;
+        argmin_fn = argmin_sse41;
+        argmax_fn = argmax_sse41;
+        impl_name = "sse4.1";
+        break;
+    default:
+        argmin_fn = argmin_scalar;
+        argmax_fn = argmax_scalar;
+        impl_name = "scalar";
+        break;
+    }
+    return 0;
+}
+
+const char *select_impl_name(void) {
+    if (!argmin_fn)
+        select_use(SELECT_AUTO);
+    return impl_name;
+}
+
+int argmin_i32(const int32_t *v, int n) {
+    if (!argmin_fn)
+        select_use(SELECT_AUTO);
+    return argmin_fn(v, n);
+}
+
+int argmax_i32(const int32_t *v, int n) {
+    if (!argmax_fn)
+        select_use(SELECT_AUTO);
+    return argmax_fn(v, n);
+}
@@ -0,0 +1,29 @@
+/**
+ * Vectorized selection over a task table column.
+ *
+ * argmin/argmax return the index of the smallest/largest value in
+ * v[0..n-1], the lowest index on ties, or -1 if n is 0. The AVX2 or
+ * SSE4.1 kernel is picked at runtime from what the CPU supports, with
+ * a scalar fallback.
+ */
+
+#ifndef SELECT_H
+#define SELECT_H
+
+#include <stdint.h>
+
+enum select_impl {
+    SELECT_AUTO,
+    SELECT_SCALAR,
+    SELECT_SSE41,
+    SELECT_AVX2
+};
+
+int argmin_i32(const int32_t *v, int n);
+int argmax_i32(const int32_t *v, int n);
+
+// force a kernel (e.g. for benchmarking); returns -1 if the CPU lacks it
+int select_use(enum select_impl impl);
+const char *select_impl_name(void);
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * Proportional-share accounting
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "share.h"
+
+// the first sample; fewer allocations say little about fairness
+#define FIRST_SAMPLE 16
+
+static int share_class(const Task *task) {
+    if (task->priority < MIN_PRIORITY)
+        return 0;
+    if (task->priority > MAX_PRIORITY)
+        return SHARE_CLASSES - 1;
+    return task->priority - MIN_PRIORITY;
+}
+
+int share_tickets(const Task *task) {
+    return share_class(task) + 1;
+}
+
+void share_init(struct share *share) {
+    memset(share, 0, sizeof(*share));
+}
+
+void share_add(struct share *share, const Task *task) {
+    share->tickets[share_class(task)] += share_tickets(task);
+    share->total += share_tickets(task);
+}
+
+void share_remove(struct share *share, const Task *task) {
+    share->tickets[share_class(task)] -= share_tickets(task);
+    share->total -= share_tickets(task);
+}
+
+static double max_error(const struct share *share) {
+    double max = 0;
+    int c;
+
+    for (c = 0; c < SHARE_CLASSES; c++) {
+        double error = fabs(share->wins[c] - share->ideal[c]);
+        if (error > max)
+            max = error;
+    }
+    return max;
+}
+
+void share_pick(struct share *share, const Task *task) {
+    int c;
+
+    for (c = 0; c < SHARE_CLASSES; c++)
+        if (share->tickets[c] > 0)
+            share->ideal[c] += (double)share->tickets[c] / share->total;
+    share->wins[share_class(task)]++;
+    share->picks++;
+
+    // sample at every power of two
+    if (share->picks >= FIRST_SAMPLE && (share->picks & (share->picks - 1)) == 0 &&
+        share->nsamples < SHARE_SAMPLES) {
+        struct share_sample *sample = &share->samples[share->nsamples++];
+        sample->picks = share->picks;
+        sample->max_error = max_error(share);
+        sample->share_error = sample->max_error / share->picks;
+    }
+}
+
+void share_report(const char *name, const struct share *const *shares, int n) {
+    long long wins[SHARE_CLASSES] = { 0 }, picks = 0;
+    double ideal[SHARE_CLASSES] = { 0 };
+    int c, i, s;
+
+    // with several CPUs, each row is the worst CPU that got that far
+    printf("\n--- %s Fairness Over Time ---\n", name);
+    printf("%12s %12s %12s\n", "Allocations", "Max Error", "Share Error");
+    for (s = 0; s < SHARE_SAMPLES; s++) {
+        struct share_sample worst = { 0, 0, 0 };
+        for (i = 0; i < n; i++) {
+            if (s >= shares[i]->nsamples)
+                continue;
+            worst.picks = shares[i]->samples[s].picks;
+            if (shares[i]->samples[s].max_error > worst.max_error) {
+                worst.max_error = shares[i]->samples[s].max_error;
+                worst.share_error = shares[i]->samples[s].share_error;
+            }
+        }
+        if (worst.picks == 0)
+            break;
+        printf("%12lld %12.2f %11.3f%%\n", worst.picks, worst.max_error, 100 * worst.share_error);
+    }
+
+    for (i = 0; i < n; i++) {
+        for (c = 0; c < SHARE_CLASSES; c++) {
+            wins[c] += shares[i]->wins[c];
+            ideal[c] += shares[i]->ideal[c];
+        }
+        picks += shares[i]->picks;
+    }
+
+    printf("\n--- %s Share by Priority ---\n", name);
+    printf("%8s %8s %12s %12s %10s %8s %8s\n", "Priority", "Tickets", "Allocations", "Ideal", "Error", "Share", "Ideal");
+    for (c = 0; c < SHARE_CLASSES; c++) {
+        if (wins[c] == 0 && ideal[c] == 0)
+            continue;
+        printf("%8d %8d %12lld %12.1f %10.1f %7.2f%% %7.2f%%\n", c + MIN_PRIORITY, c + 1, wins[c], ideal[c],
+               wins[c] - ideal[c], picks > 0 ? 100.0 * wins[c] / picks : 0,
+               picks > 0 ? 100.0 * ideal[c] / picks : 0);
+    }
+}
@@ -0,0 +1,53 @@
+/**
+ * Proportional-share accounting for the lottery and stride policies.
+ *
+ * Each pick is one allocation of the CPU. A priority class's ideal
+ * share of that allocation is its part of the tickets queued at the
+ * time, so summing those parts gives the allocations it should have
+ * won so far. The error is how far its actual wins are from that: it
+ * grows with the square root of the allocations for lottery and stays
+ * within a few allocations for stride. A task that completes keeps
+ * whatever lead or lag it had, so with many short tasks the stride
+ * error drifts as well. Samples are taken at every power of two
+ * allocations to show how the error develops over the run.
+ */
+
+#ifndef SHARE_H
+#define SHARE_H
+
+#include "task.h"
+#include "schedulers.h"
+
+#define SHARE_CLASSES (MAX_PRIORITY - MIN_PRIORITY + 1)
+#define SHARE_SAMPLES 64
+
+struct share_sample {
+    long long picks;
+    double max_error;       // largest |wins - ideal| of any class, in allocations
+    double share_error;     // the same as a fraction of all allocations
+};
+
+struct share {
+    long long tickets[SHARE_CLASSES];   // tickets queued per class
+    long long total;
+    long long wins[SHARE_CLASSES];
+    double ideal[SHARE_CLASSES];
+    long long picks;
+    int nsamples;
+    struct share_sample samples[SHARE_SAMPLES];
+};
+
+// a task's tickets: its priority, so priority 10 gets ten times priority 1
+int share_tickets(const Task *task);
+
+void share_init(struct share *share);
+void share_add(struct share *share, const Task *task);
+void share_remove(struct share *share, const Task *task);
+
+// the task won an allocation; call while its tickets are still queued
+void share_pick(struct share *share, const Task *task);
+
+// print the error over time and per class, given every CPU's accounts
+void share_report(const char *name, const struct share *const *shares, int n);
+
+#endif
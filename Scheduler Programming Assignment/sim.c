@@ -0,0 +1,1060 @@
+/**
+ * Event-driven simulation of one or more CPUs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+
+#include "sim.h"
+#include "schedulers.h"
+#include "calq.h"
+#include "hist.h"
+#include "radix.h"
+#include "arena.h"
+#include "cpu.h"
+#include "workload.h"
+
+// event types; at equal times arrivals and tasks back from I/O are
+// handled before CPU events, and periodic policy work comes last
+enum {
+    EV_ARRIVAL,
+    EV_WAKEUP,              // a device finished a task's I/O burst
+    EV_COMPLETION,
+    EV_BLOCK,               // a CPU burst ended and an I/O burst follows
+    EV_EXPIRY,
+    EV_PERIODIC
+};
+
+// latency distributions of a group of tasks
+struct latency {
+    struct hist turnaround;
+    struct hist response;
+    struct hist wait;
+};
+
+#define PRIO_CLASSES (MAX_PRIORITY - MIN_PRIORITY + 1)
+
+// without --horizon, periodic tasks are released for one hyperperiod
+// after the last one arrives, but for at most this many of the longest
+// period when the periods have a large common multiple
+#define HYPERPERIOD_CAP 1000
+
+struct cpu {
+    void *rq;
+    Task *running;
+    struct event *event;    // the running task's completion or expiry
+    int last_tid;           // task dispatched last, -1 before the first
+    long long switches;
+    long long preemptions;
+    long long busy;         // time spent running tasks
+    long long overhead;     // time spent switching between them
+    double owed;            // overhead not yet charged, less than a unit
+    long long dispatches;
+    int completed;
+    int pushed_in;          // arrivals pushed here from an overloaded CPU
+    int stolen_in;          // tasks this CPU stole while idle
+};
+
+// an I/O device, serving one request at a time in order of arrival
+struct device {
+    struct list queue;      // tasks waiting for the device
+    Task *serving;
+    long long busy;         // time spent serving requests
+    long long requests;
+    long long waited;       // time requests spent in the queue
+    int max_queue;
+};
+
+struct sim {
+    const struct policy *policy;
+    int quantum;
+    double switch_cost;
+    double resume_cost;
+    int quiet;
+    struct task_source *source;
+    long long interval;
+    long long next_report;
+    struct cpu_log *log;    // NULL if dispatches are not logged
+    struct cpu *cpus;
+    int ncpus;
+    struct calq events;
+    struct event *free_events;
+    struct arena event_arena;
+    long long now;
+    long long makespan;
+    int queued;             // tasks waiting in any ready queue
+    long long period;       // of the policy's periodic work, 0 if none
+    int skip_rounds;        // whether round-robin rounds may be skipped
+    int skip_wait;          // dispatches until the next attempt
+
+    int task_count;
+    int completed;
+    struct latency all;
+    struct latency *by_priority[PRIO_CLASSES];  // allocated on first use
+
+    // periodic tasks: their jobs are copies released by the engine
+    long long horizon;      // no job is released at or after this time
+    Task *free_jobs;
+    struct arena job_arena;
+    int periodic_tasks;
+    double utilization;     // sum of burst / period
+    double density;         // sum of burst / min(deadline, period)
+    long long longest_period;
+    long long last_offset;  // latest arrival of a periodic task
+    long long hyperperiod;  // least common multiple of the periods, capped
+
+    // jobs with a deadline
+    long long deadline_jobs;
+    long long missed;
+    struct hist lateness;   // of the jobs that missed their deadline
+    struct hist slack;      // of the jobs that met it
+
+    // I/O devices, allocated up to the highest one used
+    struct device *devices;
+    int ndevices;
+    int busy_devices;
+    long long accounted;    // the overlap below is counted up to this time
+    long long overlap;      // time a CPU and a device were busy at once
+};
+
+static void latency_init(struct latency *latency) {
+    hist_init(&latency->turnaround);
+    hist_init(&latency->response);
+    hist_init(&latency->wait);
+}
+
+static void latency_free(struct latency *latency) {
+    hist_free(&latency->turnaround);
+    hist_free(&latency->response);
+    hist_free(&latency->wait);
+}
+
+// the distributions for the task's priority, clamped to the valid range
+static struct latency *priority_class(struct sim *sim, Task *task) {
+    int p = task->priority;
+
+    if (p < MIN_PRIORITY)
+        p = MIN_PRIORITY;
+    if (p > MAX_PRIORITY)
+        p = MAX_PRIORITY;
+    p -= MIN_PRIORITY;
+
+    if (!sim->by_priority[p]) {
+        sim->by_priority[p] = malloc(sizeof(struct latency));
+        if (!sim->by_priority[p]) {
+            fprintf(stderr, "malloc failed in priority_class()\n");
+            exit(EXIT_FAILURE);
+        }
+        latency_init(sim->by_priority[p]);
+    }
+    return sim->by_priority[p];
+}
+
+static struct event *post(struct sim *sim, int type, long long time, int cpu, Task *task) {
+    struct event *ev = sim->free_events;
+
+    if (ev)
+        sim->free_events = ev->next;
+    else
+        ev = arena_alloc(&sim->event_arena, sizeof(struct event));
+
+    ev->type = type;
+    ev->time = time;
+    ev->cpu = cpu;
+    ev->task = task;
+    calq_insert(&sim->events, ev);
+    return ev;
+}
+
+static void release(struct sim *sim, struct event *ev) {
+    ev->next = sim->free_events;
+    sim->free_events = ev;
+}
+
+// queued tasks plus the running one
+static int load(struct sim *sim, int cpu) {
+    return sim->policy->size(sim->cpus[cpu].rq) + (sim->cpus[cpu].running != NULL);
+}
+
+/*
+ * An arrival may take the CPU from the running task: its slice is cut
+ * short at this instant and it goes back to the ready queue with the
+ * rest of its burst. The CPU is then free for the next dispatch.
+ */
+static void preempt_check(struct sim *sim, int c, Task *arrived) {
+    struct cpu *cpu = &sim->cpus[c];
+    Task *running = cpu->running;
+    int left = cpu->event->time - sim->now;
+    // preempted while still switching to it, the task gets its whole slice back
+    int unused = left < running->ran ? left : running->ran;
+
+    // let the policy compare against what the running task has left now
+    running->burst += unused;
+    running->ran -= unused;
+    if (!sim->policy->preempts(cpu->rq, arrived, running)) {
+        running->burst -= unused;
+        running->ran += unused;
+        return;
+    }
+
+    calq_remove(&sim->events, cpu->event);
+    release(sim, cpu->event);
+    cpu->event = NULL;
+    cpu->running = NULL;
+    cpu->busy -= unused;
+    cpu->overhead -= left - unused;
+    cpu->preemptions++;
+    if (sim->log)
+        cpu_log_preempt(sim->log, c, sim->now, running, unused);
+
+    if (sim->policy->preempted)
+        sim->policy->preempted(cpu->rq, running);
+    else
+        sim->policy->enqueue(cpu->rq, running);
+    sim->queued++;
+}
+
+/*
+ * Push balancing: a task arrives on its home CPU (tids spread round
+ * robin) unless that CPU has at least two more tasks than the least
+ * loaded one, in which case it is pushed there instead. enqueue is the
+ * policy hook that takes it.
+ */
+static void place(struct sim *sim, Task *task, void (*enqueue)(void *rq, Task *task)) {
+    int home = task->tid % sim->ncpus;
+    int target = home;
+    int c;
+
+    for (c = 0; c < sim->ncpus; c++)
+        if (load(sim, c) < load(sim, target))
+            target = c;
+
+    if (target != home && load(sim, home) - load(sim, target) >= 2)
+        sim->cpus[target].pushed_in++;
+    else
+        target = home;
+
+    enqueue(sim->cpus[target].rq, task);
+    sim->queued++;
+    if (sim->policy->preempts && sim->cpus[target].running)
+        preempt_check(sim, target, task);
+}
+
+/*
+ * Pull balancing: an idle CPU with an empty queue steals one task from
+ * the CPU with the most queued tasks.
+ */
+static void steal(struct sim *sim, int cpu) {
+    const struct policy *policy = sim->policy;
+    int busiest = -1;
+    int most = 0;
+    int c;
+
+    for (c = 0; c < sim->ncpus; c++) {
+        int queued = policy->size(sim->cpus[c].rq);
+        if (c != cpu && queued > most) {
+            most = queued;
+            busiest = c;
+        }
+    }
+    if (busiest == -1)
+        return;
+
+    Task *task = policy->steal(sim->cpus[busiest].rq);
+    if (task) {
+        policy->enqueue(sim->cpus[cpu].rq, task);
+        sim->cpus[cpu].stolen_in++;
+    }
+}
+
+/*
+ * Round-robin fast-forward on one CPU. While no arrival is due, the
+ * ready queue just rotates, so rounds in which nobody completes can be
+ * applied at once. A failed attempt costs a pass over the round, so
+ * the next one waits until a round has been simulated.
+ */
+static void skip_rounds(struct sim *sim, struct cpu *cpu) {
+    struct event *next = calq_peek(&sim->events);
+    long long until = next ? next->time : LLONG_MAX;
+    long long skipped;
+    int tasks;
+
+    if (sim->skip_wait > 0) {
+        sim->skip_wait--;
+        return;
+    }
+
+    // stop short of the next arrival and of the next interval report
+    if (sim->interval > 0 && sim->next_report < until)
+        until = sim->next_report;
+    skipped = sim->policy->skip_rounds(cpu->rq, sim->quantum, until - sim->now - 1, &tasks);
+    if (skipped == 0) {
+        sim->skip_wait = sim->policy->size(cpu->rq);
+        return;
+    }
+    sim->now += skipped;
+    cpu->busy += skipped;
+    cpu->dispatches += skipped / sim->quantum;
+    if (tasks > 1)
+        cpu->switches += skipped / sim->quantum;
+}
+
+// give a CPU to its next ready task, if there is one
+static void dispatch(struct sim *sim, int c) {
+    const struct policy *policy = sim->policy;
+    struct cpu *cpu = &sim->cpus[c];
+
+    if (sim->queued == 0)
+        return;
+    if (sim->ncpus > 1 && policy->size(cpu->rq) == 0)
+        steal(sim, c);
+    if (sim->skip_rounds)
+        skip_rounds(sim, cpu);
+
+    Task *task = policy->pick_next(cpu->rq);
+    if (!task)
+        return;
+    sim->queued--;
+
+    if (!task->has_been_run) {
+        long long response = sim->now - task->arrival;
+        hist_record(&sim->all.response, response);
+        hist_record(&priority_class(sim, task)->response, response);
+        task->has_been_run = 1;
+    }
+
+    int slice;
+    if (policy->slice) {
+        slice = policy->slice(cpu->rq, task);
+        if (slice <= 0 || slice > task->burst)
+            slice = task->burst;
+    } else {
+        slice = (sim->quantum > 0 && task->burst > sim->quantum) ? sim->quantum : task->burst;
+    }
+
+    // the task starts once the CPU has switched to it
+    int overhead = 0;
+    if (cpu->last_tid != -1) {
+        cpu->owed += cpu->last_tid != task->tid ? sim->switch_cost : sim->resume_cost;
+        overhead = (int)cpu->owed;
+        cpu->owed -= overhead;
+    }
+    if (sim->log)
+        cpu_log_dispatch(sim->log, c, sim->now + overhead, task, slice);
+    task->burst -= slice;
+    task->ran = slice;
+
+    if (cpu->last_tid != -1 && cpu->last_tid != task->tid)
+        cpu->switches++;
+    cpu->last_tid = task->tid;
+    cpu->running = task;
+    cpu->busy += slice;
+    cpu->overhead += overhead;
+    cpu->dispatches++;
+    cpu->event = post(sim, task->burst > 0 ? EV_EXPIRY : task->next_io < task->nio ? EV_BLOCK : EV_COMPLETION,
+                      sim->now + overhead + slice, c, task);
+}
+
+// the device, allocated along with any below it on first use
+static struct device *device(struct sim *sim, int d) {
+    if (d >= sim->ndevices) {
+        struct device *devices = realloc(sim->devices, (d + 1) * sizeof(struct device));
+        if (!devices) {
+            fprintf(stderr, "realloc failed in device()\n");
+            exit(EXIT_FAILURE);
+        }
+        memset(&devices[sim->ndevices], 0, (d + 1 - sim->ndevices) * sizeof(struct device));
+        if (sim->ndevices == 0)
+            sim->accounted = sim->now;
+        sim->devices = devices;
+        sim->ndevices = d + 1;
+    }
+    return &sim->devices[d];
+}
+
+// start on a task's I/O burst; the task is back when it is done
+static void serve(struct sim *sim, int d, Task *task) {
+    struct device *dev = &sim->devices[d];
+    int length = task->io[task->next_io].io;
+
+    dev->serving = task;
+    dev->busy += length;
+    dev->requests++;
+    dev->waited += sim->now - task->requested;
+    sim->busy_devices++;
+    post(sim, EV_WAKEUP, sim->now + length, d, task);
+}
+
+// queue a task that finished a CPU burst for the device of its next I/O burst
+static void request_io(struct sim *sim, Task *task) {
+    int d = task->io[task->next_io].device;
+    struct device *dev = device(sim, d);
+
+    task->requested = sim->now;
+    if (!dev->serving) {
+        serve(sim, d, task);
+        return;
+    }
+    append(&dev->queue, task);
+    if (dev->queue.count > dev->max_queue)
+        dev->max_queue = dev->queue.count;
+}
+
+// count the time since the last event during which a CPU and a device
+// were both busy
+static void account_overlap(struct sim *sim, long long until) {
+    int c;
+
+    if (sim->busy_devices > 0) {
+        for (c = 0; c < sim->ncpus; c++) {
+            if (sim->cpus[c].running) {
+                sim->overlap += until - sim->accounted;
+                break;
+            }
+        }
+    }
+    sim->accounted = until;
+}
+
+// CPU time over every burst of the task
+static long long cpu_demand(const Task *task) {
+    long long demand = task->initial_burst;
+    int i;
+
+    for (i = 0; i < task->nio; i++)
+        demand += task->io[i].cpu;
+    return demand;
+}
+
+static long long gcd(long long a, long long b) {
+    while (b) {
+        long long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// account for a task from the source in the admission check and horizon
+static void admit(struct sim *sim, Task *task) {
+    long long cap;
+
+    if (task->period == 0)
+        return;
+
+    sim->periodic_tasks++;
+    sim->utilization += (double)cpu_demand(task) / task->period;
+    sim->density += (double)cpu_demand(task) /
+                    (task->deadline < task->period ? task->deadline : task->period);
+    if (task->period > sim->longest_period)
+        sim->longest_period = task->period;
+    if (task->arrival > sim->last_offset)
+        sim->last_offset = task->arrival;
+
+    cap = HYPERPERIOD_CAP * sim->longest_period;
+    if (sim->hyperperiod == 0)
+        sim->hyperperiod = task->period;
+    else if (sim->hyperperiod < cap && sim->hyperperiod / gcd(sim->hyperperiod, task->period) <= cap / task->period)
+        sim->hyperperiod = sim->hyperperiod / gcd(sim->hyperperiod, task->period) * task->period;
+    else
+        sim->hyperperiod = cap;
+    if (sim->hyperperiod > cap)
+        sim->hyperperiod = cap;
+}
+
+static long long horizon(struct sim *sim) {
+    long long horizon = sim->horizon > 0 ? sim->horizon : sim->last_offset + sim->hyperperiod;
+
+    return horizon < INT_MAX ? horizon : INT_MAX;
+}
+
+// whether the horizon can still move: the default one grows with each
+// periodic task an ordered source has yet to hand over
+static int horizon_known(struct sim *sim) {
+    return sim->horizon > 0 || !sim->source->ordered;
+}
+
+/*
+ * Post the job of a periodic task that follows this one; the task lives
+ * on until its last job completes. A job past a horizon that is still
+ * growing is posted anyway and dropped when it is due (see handle()).
+ */
+static void release_next(struct sim *sim, Task *job) {
+    Task *origin = job->origin ? job->origin : job;
+    long long at = (long long)job->arrival + job->period;
+    struct task_spec spec = { .name = origin->name, .priority = origin->priority,
+                              .burst = origin->initial_burst, .nio = origin->nio,
+                              .deadline = origin->deadline, .period = origin->period };
+    Task *next;
+
+    if (at >= horizon(sim) && horizon_known(sim))
+        return;
+
+    if ((next = sim->free_jobs) != NULL)
+        sim->free_jobs = next->next;
+    else
+        next = arena_alloc(&sim->job_arena, sizeof(Task));
+
+    spec.arrival = at;
+    task_init(next, origin->tid, &spec, origin->io);
+    next->origin = origin;
+    origin->jobs++;
+
+    post(sim, EV_ARRIVAL, at, 0, next);
+}
+
+// a task has completed: hand it back to the source or to the free jobs
+static void retire(struct sim *sim, Task *task) {
+    Task *origin = task->origin ? task->origin : task;
+
+    if (task != origin) {
+        task->next = sim->free_jobs;
+        sim->free_jobs = task;
+    }
+    if (origin->period > 0 && --origin->jobs > 0)
+        return;
+    if (sim->source->retire)
+        sim->source->retire(sim->source->arg, origin);
+}
+
+static void record_deadline(struct sim *sim, Task *task) {
+    long long lateness = sim->now - ((long long)task->arrival + task->deadline);
+
+    sim->deadline_jobs++;
+    if (lateness > 0) {
+        sim->missed++;
+        hist_record(&sim->lateness, lateness);
+    } else {
+        hist_record(&sim->slack, -lateness);
+    }
+}
+
+// pull the next task from the source and make it a pending arrival
+static int arrive_next(struct sim *sim) {
+    Task *task = sim->source->next(sim->source->arg);
+
+    if (!task)
+        return 0;
+    if (task->arrival < sim->now)
+        task->arrival = sim->now;
+    admit(sim, task);
+    post(sim, EV_ARRIVAL, task->arrival, 0, task);
+    sim->task_count++;
+    return 1;
+}
+
+/*
+ * Metrics-only runs of a non-preemptive policy on one CPU need no
+ * simulation when every task is ready at time 0: the tasks run back to
+ * back in the policy's run order, so sorting them by it (radix sort,
+ * O(n)) gives every start time as a prefix sum of the bursts.
+ */
+static int can_shortcut(struct sim *sim, const struct sim_options *options) {
+    return sim->policy->run_order && !sim->policy->slice && !sim->period &&
+           sim->quantum == 0 && sim->ncpus == 1 && sim->switch_cost == 0 &&
+           !sim->log && sim->interval == 0 && !options->no_shortcuts;
+}
+
+// pull every task; returns 0, with them posted as arrivals, if the
+// shortcut does not apply after all
+static int shortcut(struct sim *sim) {
+    const struct policy *policy = sim->policy;
+    struct cpu *cpu = &sim->cpus[0];
+    Task **tasks = NULL;
+    uint64_t *keys;
+    size_t n = 0, capacity = 0, i;
+    int late = 0;
+    Task *task;
+
+    while ((task = sim->source->next(sim->source->arg)) != NULL) {
+        if (n == capacity) {
+            capacity = capacity ? capacity * 2 : 1024;
+            tasks = realloc(tasks, capacity * sizeof(Task *));
+            if (!tasks) {
+                fprintf(stderr, "realloc failed in shortcut()\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        tasks[n++] = task;
+        // deadlines, periodic releases and I/O are only tracked by the simulation
+        late |= task->arrival > 0 || task->deadline > 0 || task->period > 0 || task->nio > 0;
+    }
+
+    if (late) {
+        for (i = 0; i < n; i++) {
+            admit(sim, tasks[i]);
+            post(sim, EV_ARRIVAL, tasks[i]->arrival, 0, tasks[i]);
+            sim->task_count++;
+        }
+        free(tasks);
+        return 0;
+    }
+
+    keys = malloc((n ? n : 1) * sizeof(uint64_t));
+    if (!keys) {
+        fprintf(stderr, "malloc failed in shortcut()\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < n; i++)
+        keys[i] = policy->run_order(tasks[i]);
+    radix_sort(keys, (void **)tasks, n);
+
+    for (i = 0; i < n; i++) {
+        struct latency *class;
+
+        task = tasks[i];
+        class = priority_class(sim, task);
+        hist_record(&sim->all.response, sim->now);
+        hist_record(&class->response, sim->now);
+        hist_record(&sim->all.wait, sim->now);
+        hist_record(&class->wait, sim->now);
+        task->has_been_run = 1;
+        sim->now += task->burst;
+        task->burst = 0;
+        hist_record(&sim->all.turnaround, sim->now);
+        hist_record(&class->turnaround, sim->now);
+
+        cpu->busy += task->initial_burst;
+        if (i > 0)
+            cpu->switches++;
+        cpu->dispatches++;
+        cpu->completed++;
+        sim->task_count++;
+        sim->completed++;
+        sim->makespan = sim->now;
+        if (sim->source->retire)
+            sim->source->retire(sim->source->arg, task);
+    }
+
+    free(keys);
+    free(tasks);
+    return 1;
+}
+
+static void handle(struct sim *sim, struct event *ev) {
+    const struct policy *policy = sim->policy;
+    struct cpu *cpu = &sim->cpus[ev->cpu];
+    Task *task = ev->task;
+    int c;
+
+    switch (ev->type) {
+    case EV_ARRIVAL:
+        if (task->origin) {
+            if (task->arrival >= horizon(sim)) {
+                retire(sim, task);
+                break;
+            }
+            sim->task_count++;
+        }
+        if (task->period > 0) {
+            if (!task->origin)
+                task->jobs = 1;
+            release_next(sim, task);
+        }
+        place(sim, task, policy->enqueue);
+        if (sim->source->ordered && !task->origin)
+            arrive_next(sim);
+        break;
+
+    case EV_WAKEUP: {
+        struct device *dev = &sim->devices[ev->cpu];
+
+        task->blocked += sim->now - task->requested;
+        task->burst = task->io[task->next_io++].cpu;
+        dev->serving = NULL;
+        sim->busy_devices--;
+        if (dev->queue.count > 0)
+            serve(sim, ev->cpu, dequeue(&dev->queue));
+        place(sim, task, policy->wakeup ? policy->wakeup : policy->enqueue);
+        break;
+    }
+
+    case EV_COMPLETION: {
+        long long turnaround = sim->now - task->arrival;
+        long long wait = turnaround - cpu_demand(task) - task->blocked;
+        struct latency *class = priority_class(sim, task);
+        hist_record(&sim->all.turnaround, turnaround);
+        hist_record(&sim->all.wait, wait);
+        hist_record(&class->turnaround, turnaround);
+        hist_record(&class->wait, wait);
+        if (task->deadline > 0)
+            record_deadline(sim, task);
+        sim->makespan = sim->now;
+        sim->completed++;
+        cpu->running = NULL;
+        cpu->completed++;
+        retire(sim, task);
+        break;
+    }
+
+    case EV_BLOCK:
+        cpu->running = NULL;
+        if (policy->block)
+            policy->block(cpu->rq, task);
+        request_io(sim, task);
+        break;
+
+    case EV_EXPIRY:
+        cpu->running = NULL;
+        sim->queued++;
+        if (policy->requeue)
+            policy->requeue(cpu->rq, task);
+        else
+            policy->enqueue(cpu->rq, task);
+        break;
+
+    case EV_PERIODIC: {
+        struct event *next = calq_peek(&sim->events);
+        long long at = sim->now + sim->period;
+        int busy = sim->queued > 0;
+
+        // stop once nothing else is going to happen
+        if (!next && !busy)
+            break;
+
+        for (c = 0; c < sim->ncpus; c++) {
+            busy |= sim->cpus[c].running != NULL;
+            policy->periodic(sim->cpus[c].rq, sim->cpus[c].running);
+        }
+
+        // while the system is idle, skip the periods before the next arrival
+        if (!busy && next->time > at)
+            at += (next->time - at) / sim->period * sim->period;
+        post(sim, EV_PERIODIC, at, 0, NULL);
+        break;
+    }
+    }
+}
+
+// running totals, printed every interval
+static void report_interval(struct sim *sim) {
+    const struct hist *response = &sim->all.response;
+    int n = sim->completed;
+
+    printf("[%lld] completed %d, live %d", sim->now, n, sim->task_count - n);
+    if (n > 0)
+        printf(", avg turnaround %.2f, waiting %.2f, p99 turnaround %lld",
+               (double)sim->all.turnaround.sum / n, (double)sim->all.wait.sum / n,
+               hist_percentile(&sim->all.turnaround, 99));
+    if (response->count > 0)
+        printf(", avg response %.2f", (double)response->sum / response->count);
+    printf("\n");
+}
+
+static void report_switches(struct sim *sim) {
+    long long switches = 0, preemptions = 0, overhead = 0;
+    int c;
+
+    for (c = 0; c < sim->ncpus; c++) {
+        switches += sim->cpus[c].switches;
+        preemptions += sim->cpus[c].preemptions;
+        overhead += sim->cpus[c].overhead;
+    }
+    printf("Context Switches: %lld\n", switches);
+    printf("Preemptions: %lld\n", preemptions);
+    if (sim->switch_cost > 0 || sim->resume_cost > 0)
+        printf("Switch Overhead: %lld (%.2f%% of the CPU time)\n", overhead,
+               sim->makespan > 0 ? 100.0 * overhead / (sim->makespan * sim->ncpus) : 0);
+}
+
+static void report_row(const char *metric, const char *class, const struct hist *hist) {
+    printf("%-10s %-8s %9lld %9lld %9lld %9lld %9lld %9lld\n", metric, class, hist->count,
+           hist_percentile(hist, 50), hist_percentile(hist, 90), hist_percentile(hist, 99),
+           hist_percentile(hist, 99.9), hist->max);
+}
+
+// percentiles of every metric, over all tasks and per priority
+static void report_latency(struct sim *sim) {
+    static const char *metrics[] = { "Turnaround", "Response", "Waiting" };
+    char class[16];
+    int m, p;
+
+    printf("\n--- %s Latency Percentiles ---\n", sim->policy->name);
+    printf("%-10s %-8s %9s %9s %9s %9s %9s %9s\n", "Metric", "Class", "Tasks", "p50", "p90", "p99", "p99.9", "Max");
+    for (m = 0; m < 3; m++) {
+        const struct hist *all = m == 0 ? &sim->all.turnaround : m == 1 ? &sim->all.response : &sim->all.wait;
+
+        report_row(metrics[m], "all", all);
+        for (p = 0; p < PRIO_CLASSES; p++) {
+            struct latency *l = sim->by_priority[p];
+            if (!l)
+                continue;
+            snprintf(class, sizeof(class), "prio %d", p + MIN_PRIORITY);
+            report_row(metrics[m], class, m == 0 ? &l->turnaround : m == 1 ? &l->response : &l->wait);
+        }
+    }
+}
+
+/*
+ * Utilization of the CPUs and of every device used, and the time both
+ * were busy at once: the more a policy overlaps computation with I/O,
+ * the sooner an I/O-heavy workload is done.
+ */
+static void report_io(struct sim *sim) {
+    long long busy = 0;
+    int c, d;
+
+    for (c = 0; c < sim->ncpus; c++)
+        busy += sim->cpus[c].busy;
+
+    printf("\n--- %s I/O ---\n", sim->policy->name);
+    printf("CPU Utilization: %.2f%%\n",
+           sim->makespan > 0 ? 100.0 * busy / ((double)sim->makespan * sim->ncpus) : 0);
+    printf("CPU/IO Overlap: %lld (%.2f%% of the makespan)\n", sim->overlap,
+           sim->makespan > 0 ? 100.0 * sim->overlap / sim->makespan : 0);
+    printf("%6s %12s %12s %10s %10s %10s\n", "Device", "Busy", "Utilization", "Requests", "Avg Wait", "Max Queue");
+    for (d = 0; d < sim->ndevices; d++) {
+        const struct device *dev = &sim->devices[d];
+        if (dev->requests == 0)
+            continue;
+        printf("%6d %12lld %11.2f%% %10lld %10.2f %10d\n", d, dev->busy,
+               sim->makespan > 0 ? 100.0 * dev->busy / sim->makespan : 0, dev->requests,
+               (double)dev->waited / dev->requests, dev->max_queue);
+    }
+}
+
+// a sufficient test passes within the bound; no policy can keep up above 1
+static const char *verdict(double density, double utilization, double bound) {
+    if (density <= bound)
+        return "schedulable";
+    return utilization <= 1 ? "inconclusive" : "not schedulable";
+}
+
+/*
+ * Deadline misses, and the classic admission tests for the periodic
+ * tasks: EDF meets every deadline if the density is at most 1 (the
+ * utilization must be), rate-monotonic if it is within the Liu and
+ * Layland bound n(2^(1/n) - 1). With several CPUs the tests are applied
+ * to the load per CPU, as if the tasks were partitioned evenly.
+ */
+static void report_deadlines(struct sim *sim) {
+    printf("\n--- %s Deadlines ---\n", sim->policy->name);
+    if (sim->deadline_jobs > 0) {
+        printf("Jobs with Deadlines: %lld, Missed: %lld (%.2f%%)\n", sim->deadline_jobs, sim->missed,
+               100.0 * sim->missed / sim->deadline_jobs);
+        printf("%-10s %-8s %9s %9s %9s %9s %9s %9s\n", "Metric", "Jobs", "Count", "p50", "p90", "p99", "p99.9", "Max");
+        report_row("Lateness", "missed", &sim->lateness);
+        report_row("Slack", "met", &sim->slack);
+    }
+    if (sim->periodic_tasks > 0) {
+        int n = sim->periodic_tasks;
+        double u = sim->utilization / sim->ncpus;
+        double d = sim->density / sim->ncpus;
+        double rm_bound = n * (pow(2.0, 1.0 / n) - 1);
+
+        printf("Periodic Tasks: %d, Utilization: %.3f, Density: %.3f%s\n", n, u, d,
+               sim->ncpus > 1 ? " (per CPU)" : "");
+        printf("EDF Admission (bound 1.000): %s\n", verdict(d, u, 1));
+        printf("RMS Admission (bound %.3f): %s\n", rm_bound, verdict(d, u, rm_bound));
+    }
+}
+
+static void report_policy(struct sim *sim) {
+    void **rqs = malloc(sim->ncpus * sizeof(void *));
+    int c;
+
+    if (!rqs) {
+        fprintf(stderr, "malloc failed in report_policy()\n");
+        exit(EXIT_FAILURE);
+    }
+    for (c = 0; c < sim->ncpus; c++)
+        rqs[c] = sim->cpus[c].rq;
+    sim->policy->report(rqs, sim->ncpus);
+    free(rqs);
+}
+
+static void report_cpus(struct sim *sim) {
+    long long total_busy = 0, max_busy = 0;
+    int pushed = 0, stolen = 0;
+    double mean, var = 0;
+    int c;
+
+    printf("\n--- Per-CPU Statistics (%d CPUs) ---\n", sim->ncpus);
+    printf("CPU %12s %12s %11s %10s %10s %10s\n", "Busy", "Utilization", "Dispatches", "Completed", "Pushed-in", "Stolen-in");
+    for (c = 0; c < sim->ncpus; c++) {
+        struct cpu *cpu = &sim->cpus[c];
+        double util = sim->makespan > 0 ? 100.0 * cpu->busy / sim->makespan : 0;
+        printf("%3d %12lld %11.2f%% %11lld %10d %10d %10d\n", c, cpu->busy, util,
+               cpu->dispatches, cpu->completed, cpu->pushed_in, cpu->stolen_in);
+        total_busy += cpu->busy;
+        if (cpu->busy > max_busy)
+            max_busy = cpu->busy;
+        pushed += cpu->pushed_in;
+        stolen += cpu->stolen_in;
+    }
+
+    mean = (double)total_busy / sim->ncpus;
+    for (c = 0; c < sim->ncpus; c++)
+        var += (sim->cpus[c].busy - mean) * (sim->cpus[c].busy - mean);
+    var /= sim->ncpus;
+
+    printf("Migrations: %d (%d pushed, %d stolen)\n", pushed + stolen, pushed, stolen);
+    printf("Load Imbalance: max/mean busy = %.3f, busy CoV = %.3f\n",
+           mean > 0 ? max_busy / mean : 0, mean > 0 ? sqrt(var) / mean : 0);
+}
+
+static Task *list_next(void *tasks) {
+    return dequeue(tasks);
+}
+
+void simulate(const struct policy *policy, struct list *tasks,
+              const struct sim_options *options, struct sim_result *result) {
+    struct task_source source = { list_next, NULL, tasks, 0 };
+
+    simulate_source(policy, &source, options, result);
+}
+
+void simulate_source(const struct policy *policy, struct task_source *source,
+                     const struct sim_options *options, struct sim_result *result) {
+    struct sim sim = { 0 };
+    struct event *ev;
+    int trace;
+    int c;
+
+    sim.policy = policy;
+    sim.quantum = (policy->quantum > 0 && options->quantum > 0) ? options->quantum : policy->quantum;
+    sim.switch_cost = options->switch_cost > 0 ? options->switch_cost : 0;
+    sim.resume_cost = options->resume_cost > 0 ? options->resume_cost : 0;
+    sim.quiet = options->quiet;
+    sim.source = source;
+    sim.interval = options->interval;
+    sim.next_report = options->interval;
+    sim.ncpus = options->cpus > 0 ? options->cpus : 1;
+    sim.cpus = calloc(sim.ncpus, sizeof(struct cpu));
+    if (!sim.cpus) {
+        fprintf(stderr, "calloc failed in simulate_source()\n");
+        exit(EXIT_FAILURE);
+    }
+    for (c = 0; c < sim.ncpus; c++) {
+        sim.cpus[c].rq = policy->create(options->params);
+        sim.cpus[c].last_tid = -1;
+    }
+    sim.period = policy->period ? policy->period(sim.cpus[0].rq) : 0;
+    calq_init(&sim.events);
+    latency_init(&sim.all);
+    hist_init(&sim.lateness);
+    hist_init(&sim.slack);
+    sim.horizon = options->horizon;
+
+    // quiet runs print nothing, but may still write a binary log
+    trace = options->trace;
+    if (sim.quiet && trace == TRACE_TEXT)
+        trace = TRACE_NONE;
+    if (trace != TRACE_NONE) {
+        sim.log = cpu_log_open(trace, options->trace_path, sim.ncpus);
+        if (!sim.log)
+            exit(EXIT_FAILURE);
+    }
+
+    // skipping rounds would leave gaps in a dispatch log, and skip the
+    // overhead of every dispatch in them
+    sim.skip_rounds = policy->skip_rounds && sim.quantum > 0 && sim.ncpus == 1 &&
+                      sim.switch_cost == 0 && sim.resume_cost == 0 &&
+                      !sim.log && !options->no_shortcuts;
+
+    if (!sim.quiet) {
+        if (sim.quantum > 0)
+            printf("--- %s Scheduling (Quantum = %d) ---\n", policy->title, sim.quantum);
+        else
+            printf("--- %s Scheduling ---\n", policy->title);
+    }
+
+    // every task starts out as a pending arrival; an ordered source
+    // only has its next task pending, the rest are pulled as they arrive
+    if (source->ordered)
+        arrive_next(&sim);
+    else if (!can_shortcut(&sim, options) || !shortcut(&sim))
+        while (arrive_next(&sim))
+            ;
+    if (sim.period > 0 && sim.events.size > 0)
+        post(&sim, EV_PERIODIC, sim.period, 0, NULL);
+
+    while ((ev = calq_pop(&sim.events)) != NULL) {
+        // jump straight to the next event, skipping any idle time
+        if (sim.ndevices > 0)
+            account_overlap(&sim, ev->time);
+        sim.now = ev->time;
+        handle(&sim, ev);
+        release(&sim, ev);
+
+        if (sim.interval > 0 && sim.now >= sim.next_report) {
+            if (!sim.quiet)
+                report_interval(&sim);
+            sim.next_report = (sim.now / sim.interval + 1) * sim.interval;
+        }
+
+        // dispatch once everything happening at this instant is handled:
+        // first CPUs with work of their own, then idle ones that may steal
+        ev = calq_peek(&sim.events);
+        if (!ev || ev->time > sim.now) {
+            for (c = 0; c < sim.ncpus; c++)
+                if (!sim.cpus[c].running && policy->size(sim.cpus[c].rq) > 0)
+                    dispatch(&sim, c);
+            for (c = 0; c < sim.ncpus && sim.queued > 0; c++)
+                if (!sim.cpus[c].running)
+                    dispatch(&sim, c);
+        }
+    }
+
+    if (sim.log)
+        cpu_log_close(sim.log);
+
+    if (!sim.quiet) {
+        printf("\n--- %s Performance Metrics ---\n", policy->name);
+        if (sim.task_count > 0) {
+            printf("Average Turnaround Time: %.2f\n", (double)sim.all.turnaround.sum / sim.task_count);
+            printf("Average Response Time: %.2f\n", (double)sim.all.response.sum / sim.task_count);
+            printf("Average Waiting Time: %.2f\n", (double)sim.all.wait.sum / sim.task_count);
+            report_switches(&sim);
+            report_latency(&sim);
+        }
+        if (sim.ndevices > 0)
+            report_io(&sim);
+        if (sim.deadline_jobs > 0 || sim.periodic_tasks > 0)
+            report_deadlines(&sim);
+        if (policy->report)
+            report_policy(&sim);
+        if (sim.ncpus > 1)
+            report_cpus(&sim);
+    }
+
+    if (result) {
+        result->task_count = sim.task_count;
+        result->total_turnaround_time = sim.all.turnaround.sum;
+        result->total_response_time = sim.all.response.sum;
+        result->total_wait_time = sim.all.wait.sum;
+        result->makespan = sim.makespan;
+        result->dispatches = 0;
+        result->context_switches = 0;
+        result->preemptions = 0;
+        result->overhead = 0;
+        result->deadline_jobs = sim.deadline_jobs;
+        result->missed_deadlines = sim.missed;
+        for (c = 0; c < sim.ncpus; c++) {
+            result->dispatches += sim.cpus[c].dispatches;
+            result->context_switches += sim.cpus[c].switches;
+            result->preemptions += sim.cpus[c].preemptions;
+            result->overhead += sim.cpus[c].overhead;
+        }
+    }
+
+    latency_free(&sim.all);
+    hist_free(&sim.lateness);
+    hist_free(&sim.slack);
+    for (c = 0; c < PRIO_CLASSES; c++) {
+        if (sim.by_priority[c]) {
+            latency_free(sim.by_priority[c]);
+            free(sim.by_priority[c]);
+        }
+    }
+    free(sim.devices);
+    calq_free(&sim.events);
+    arena_release(&sim.event_arena);
+    arena_release(&sim.job_arena);
+    for (c = 0; c < sim.ncpus; c++)
+        policy->destroy(sim.cpus[c].rq);
+    free(sim.cpus);
+}
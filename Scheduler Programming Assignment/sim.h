@@ -0,0 +1,155 @@
+/**
+ * Discrete-event simulation core shared by all scheduling policies.
+ *
+ * Tasks arrive at their arrival time, wait in the policy's ready queue
+ * and are dispatched to the CPU until they complete or their quantum
+ * expires. Arrival, completion and quantum-expiry events are kept in a
+ * calendar queue and the clock jumps from one event to the next, so
+ * idle gaps cost nothing regardless of their length.
+ *
+ * A periodic task is released again every period as a new job, a copy
+ * of the task, until the horizon. Jobs with a deadline are checked
+ * against it when they complete.
+ *
+ * A task that does I/O leaves the CPU at the end of each CPU burst and
+ * queues for its device. Each device serves one request at a time,
+ * first come first served, and when a task's I/O is done it becomes
+ * ready again with its next CPU burst. A task's waiting time is the
+ * time it spent in ready queues.
+ *
+ * Dispatching is free unless the options give it a cost. A context
+ * switch to another task then keeps the CPU busy for switch_cost
+ * before the task runs, and resuming the task that ran last costs
+ * resume_cost. Costs may be fractions of a time unit; each CPU carries
+ * the fraction over until it adds up to a whole unit.
+ *
+ * With several CPUs each one has its own ready queue. An arriving task
+ * is pushed to the least loaded CPU if its home CPU is overloaded, and a
+ * CPU that runs out of work steals a task from the busiest one.
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+
+#include "task.h"
+#include "list.h"
+#include "cpu.h"
+
+// a scheduling policy, i.e. the ready queue and how it is ordered
+struct policy {
+    const char *key;                        // name on the command line, e.g. "rr"
+    const char *name;                       // short name for reports, e.g. "RR"
+    const char *title;                      // e.g. "Round-Robin"
+    int quantum;                            // time slice, 0 if non-preemptive
+    void *(*create)(const char *params);    // a new, empty ready queue; params may be NULL
+    void (*destroy)(void *rq);
+    void (*enqueue)(void *rq, Task *task);  // a task arrived
+    void (*requeue)(void *rq, Task *task);  // a task's quantum expired; NULL to enqueue
+    // Optional: the running task was preempted; its ran is the part of
+    // its slice it got to run, 0 if the CPU was still switching to it.
+    // NULL to enqueue.
+    void (*preempted)(void *rq, Task *task);
+    Task *(*pick_next)(void *rq);           // remove the next task to run, NULL if none
+    Task *(*steal)(void *rq);               // remove a task to migrate, NULL if none
+    int (*size)(void *rq);                  // number of queued tasks
+
+    // Non-preemptive policies only, optional: with every task ready at
+    // once, they run in increasing order of this key (equal keys in the
+    // order they were added). Lets metrics-only runs skip simulation.
+    uint64_t (*run_order)(const Task *task);
+
+    // Round-robin policies only, optional: apply whole rounds of the
+    // tasks that would run next, none of them completing, lasting at
+    // most max_time; return the time skipped, 0 if none, and set *tasks
+    // to the number of tasks taking turns.
+    long long (*skip_rounds)(void *rq, int quantum, long long max_time, int *tasks);
+
+    // Preemptive policies only, optional: whether a task that just
+    // arrived on rq takes the CPU from the running one. The running
+    // task's burst is what it has left at that instant and its ran what
+    // it has had of its slice so far.
+    int (*preempts)(void *rq, const Task *arrived, const Task *running);
+
+    // Optional: the slice to give a task about to be dispatched, in
+    // place of the quantum; 0 to let it run to completion.
+    int (*slice)(void *rq, Task *task);
+
+    // Optional: if period() is non-zero, periodic() is called that
+    // often with each CPU's ready queue and running task (or NULL).
+    long long (*period)(void *rq);
+    void (*periodic)(void *rq, Task *running);
+
+    // Optional: the running task finished a CPU burst and leaves for
+    // I/O; its ran is the last slice. wakeup() takes the task back when
+    // the I/O is done, possibly on another CPU's rq; NULL to enqueue.
+    void (*block)(void *rq, Task *task);
+    void (*wakeup)(void *rq, Task *task);
+
+    // Optional: print policy statistics after the metrics, given every
+    // CPU's ready queue.
+    void (*report)(void *const *rqs, int nrqs);
+};
+
+struct sim_options {
+    int cpus;                               // number of CPUs, at least 1
+    int quantum;                            // if > 0, overrides a preemptive policy's quantum
+    int quiet;                              // print nothing, only fill in the result
+    int trace;                              // how dispatches are logged, TRACE_*
+    const char *trace_path;                 // log file for TRACE_BINARY
+    long long interval;                     // if > 0, print running metrics this often
+    int no_shortcuts;                       // always simulate event by event
+    const char *params;                     // passed to the policy's create()
+    long long horizon;                      // if > 0, no periodic job is released from then on
+    double switch_cost;                     // time lost to a context switch
+    double resume_cost;                     // time lost to a dispatch of the task that ran last
+};
+
+#define SIM_OPTIONS_INIT { 1, 0, 0, TRACE_TEXT, NULL, 0, 0, NULL, 0, 0, 0 }
+
+struct sim_result {
+    int task_count;
+    long long total_turnaround_time;
+    long long total_response_time;
+    long long total_wait_time;
+    long long makespan;
+    long long dispatches;                   // slices handed to a CPU
+    long long context_switches;             // dispatches of a task other than the last one
+    long long preemptions;                  // running tasks sent back by an arrival
+    long long overhead;                     // CPU time lost to switches and dispatches
+    long long deadline_jobs;                // completed jobs that had a deadline
+    long long missed_deadlines;             // of those, the ones completed late
+};
+
+/*
+ * Where simulate_source() gets its tasks. next() returns the next task,
+ * or NULL when there are no more. If ordered is set, tasks come in order
+ * of arrival and are pulled one at a time as the clock reaches them, so
+ * only the live tasks need to exist at once; a task that claims to
+ * arrive in the past arrives now. Otherwise every task is pulled before
+ * the clock starts. retire(), if set, is handed each completed task,
+ * which the simulator does not touch again.
+ */
+struct task_source {
+    Task *(*next)(void *arg);
+    void (*retire)(void *arg, Task *task);
+    void *arg;
+    int ordered;
+};
+
+/*
+ * Run every task on the list under the given policy, log the schedule
+ * as options->trace asks, print the metrics unless quiet, and fill in
+ * result if it is not NULL.
+ * The tasks are consumed. simulate() keeps no global state, so
+ * simulations of separate task lists may run concurrently.
+ */
+void simulate(const struct policy *policy, struct list *tasks,
+              const struct sim_options *options, struct sim_result *result);
+
+// the same, with the tasks coming from a source
+void simulate_source(const struct policy *policy, struct task_source *source,
+                     const struct sim_options *options, struct sim_result *result);
+
+#endif
@@ -0,0 +1,208 @@
+/**
+ * sweep.c
+ *
+ * Runs every scheduling policy, and every preemptive one at each of a
+ * list of quanta, over one schedule and prints a comparison matrix.
+ *
+ *  ./sweep [--quanta=Q1,Q2,...] [--threads=N] [--cpus=N] [--switch-cost=C]
+ *          [--resume-cost=C] [--switch-profile=FILE] [--time-unit=US] <schedule file>
+ *
+ * The switching costs are those of ./sched. With a cost, the matrix
+ * also shows the share of CPU time lost to switching, which is what a
+ * short quantum really costs.
+ *
+ * The schedule is parsed once into a shared, read-only workload. The
+ * runs are spread over a pool of threads, each run in its own
+ * scheduler instance with tasks copied from the workload.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "schedulers.h"
+#include "trace.h"
+#include "sim.h"
+#include "workload.h"
+#include "cpu.h"
+
+#define MAX_QUANTA 64
+
+struct job {
+    const struct policy *policy;
+    struct sim_options options;
+    struct sim_result result;
+};
+
+struct pool {
+    const struct workload *workload;
+    struct job *jobs;
+    int njobs;
+    int next;               // next job to claim
+};
+
+static void *worker(void *arg) {
+    struct pool *pool = arg;
+    int i;
+
+    while ((i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED)) < pool->njobs) {
+        struct job *job = &pool->jobs[i];
+        struct scheduler *scheduler = scheduler_create(job->policy, &job->options);
+
+        scheduler_add_workload(scheduler, pool->workload);
+        scheduler_run(scheduler, &job->result);
+        scheduler_destroy(scheduler);
+    }
+    return NULL;
+}
+
+// parse a comma-separated list of positive quanta; returns the count or -1
+static int parse_quanta(const char *s, int *quanta) {
+    int n = 0;
+
+    while (*s) {
+        char *end;
+        long q = strtol(s, &end, 10);
+        if (end == s || q <= 0 || n == MAX_QUANTA || (*end && *end != ','))
+            return -1;
+        quanta[n++] = (int)q;
+        s = *end ? end + 1 : end;
+    }
+    return n;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--quanta=Q1,Q2,...] [--threads=N] [--cpus=N] [--switch-cost=C]\n"
+                    "       [--resume-cost=C] [--switch-profile=FILE] [--time-unit=US] <schedule file>\n", prog);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[]) {
+    int quanta[MAX_QUANTA] = { 5, QUANTUM, 20, 50, 100 };
+    int nquanta = 5;
+    int nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int cpus = 1;
+    char *file = NULL;
+    const char *profile = NULL;
+    double switch_cost = -1, resume_cost = -1, unit_us = 1000;
+    double switching = 0, resuming = 0;     // the costs used, from the profile or the options
+    struct workload workload;
+    struct trace trace;
+    struct pool pool;
+    int i, p, q;
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--quanta=", 9) == 0) {
+            if ((nquanta = parse_quanta(argv[i] + 9, quanta)) <= 0)
+                usage(argv[0]);
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            nthreads = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--cpus=", 7) == 0) {
+            cpus = atoi(argv[i] + 7);
+        } else if (strncmp(argv[i], "--switch-cost=", 14) == 0) {
+            switch_cost = atof(argv[i] + 14);
+        } else if (strncmp(argv[i], "--resume-cost=", 14) == 0) {
+            resume_cost = atof(argv[i] + 14);
+        } else if (strncmp(argv[i], "--switch-profile=", 17) == 0) {
+            profile = argv[i] + 17;
+        } else if (strncmp(argv[i], "--time-unit=", 12) == 0) {
+            unit_us = atof(argv[i] + 12);
+        } else if (argv[i][0] != '-' && !file) {
+            file = argv[i];
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (!file || cpus < 1 || unit_us <= 0)
+        usage(argv[0]);
+    if (profile && cpu_load_profile(profile, unit_us, &switching, &resuming) == -1)
+        exit(EXIT_FAILURE);
+    if (switch_cost >= 0)
+        switching = switch_cost;
+    if (resume_cost >= 0)
+        resuming = resume_cost;
+    if (nthreads < 1)
+        nthreads = 1;
+
+    if (trace_open(&trace, file) == -1)
+        exit(EXIT_FAILURE);
+    workload_init(&workload);
+    if (trace_load(&trace, workload_add, &workload) > 0) {
+        fprintf(stderr, "%s: malformed schedule\n", file);
+        exit(EXIT_FAILURE);
+    }
+
+    // one job per non-preemptive policy, one per quantum for the others
+    pool.workload = &workload;
+    pool.njobs = 0;
+    pool.next = 0;
+    for (p = 0; policies[p]; p++)
+        pool.njobs += policies[p]->quantum > 0 ? nquanta : 1;
+    pool.jobs = calloc(pool.njobs, sizeof(struct job));
+    if (!pool.jobs) {
+        fprintf(stderr, "calloc failed in main()\n");
+        exit(EXIT_FAILURE);
+    }
+
+    i = 0;
+    for (p = 0; policies[p]; p++) {
+        for (q = 0; q < (policies[p]->quantum > 0 ? nquanta : 1); q++) {
+            struct job *job = &pool.jobs[i++];
+            job->policy = policies[p];
+            job->options.cpus = cpus;
+            job->options.quantum = policies[p]->quantum > 0 ? quanta[q] : 0;
+            job->options.quiet = 1;
+            job->options.switch_cost = switching;
+            job->options.resume_cost = resuming;
+        }
+    }
+
+    if (nthreads > pool.njobs)
+        nthreads = pool.njobs;
+    pthread_t *threads = malloc(nthreads * sizeof(pthread_t));
+    if (!threads) {
+        fprintf(stderr, "malloc failed in main()\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < nthreads; i++)
+        if (pthread_create(&threads[i], NULL, worker, &pool) != 0) {
+            fprintf(stderr, "pthread_create failed\n");
+            exit(EXIT_FAILURE);
+        }
+    for (i = 0; i < nthreads; i++)
+        pthread_join(threads[i], NULL);
+
+    printf("--- Sweep: %d tasks, %d CPU%s, %d runs on %d thread%s ---\n",
+           workload.count, cpus, cpus == 1 ? "" : "s",
+           pool.njobs, nthreads, nthreads == 1 ? "" : "s");
+    printf("%-14s %8s %12s %12s %12s %12s",
+           "Policy", "Quantum", "Turnaround", "Waiting", "Response", "Makespan");
+    if (switching > 0 || resuming > 0)
+        printf(" %9s", "Overhead");
+    printf("\n");
+    for (i = 0; i < pool.njobs; i++) {
+        struct job *job = &pool.jobs[i];
+        int n = job->result.task_count > 0 ? job->result.task_count : 1;
+        char quantum[16] = "-";
+
+        if (job->options.quantum > 0)
+            snprintf(quantum, sizeof(quantum), "%d", job->options.quantum);
+        printf("%-14s %8s %12.2f %12.2f %12.2f %12lld", job->policy->name, quantum,
+               (double)job->result.total_turnaround_time / n,
+               (double)job->result.total_wait_time / n,
+               (double)job->result.total_response_time / n,
+               job->result.makespan);
+        if (switching > 0 || resuming > 0)
+            printf(" %8.2f%%", job->result.makespan > 0 ?
+                   100.0 * job->result.overhead / (job->result.makespan * cpus) : 0);
+        printf("\n");
+    }
+
+    free(threads);
+    free(pool.jobs);
+    trace_close(&trace);
+    workload_free(&workload);
+    return 0;
+}
@@ -5,12 +5,58 @@
 #ifndef TASK_H
 #define TASK_H
 
+// devices are numbered from 0 up to this, exclusive
+#define MAX_DEVICES 256
+
+// an I/O burst on a device, and the CPU burst that follows it
+struct io_burst {
+    int device;
+    int io;             // time the device spends on the request
+    int cpu;
+};
+
 // representation of a task
 typedef struct task {
     char *name;
     int tid;
     int priority;
-    int burst;
+    int burst;          // what is left of the current CPU burst
+    int initial_burst;  // first CPU burst, as read from the schedule
+    int has_been_run;   // set on first dispatch, for response time
+    int arrival;        // time the task enters the system
+    int deadline;       // relative to the arrival, 0 if none
+    int period;         // time between releases, 0 if not periodic
+    int jobs;           // periodic tasks: jobs released but not completed
+    int ran;            // time the task actually ran in its last slice
+    int level;          // policy-private: queue level
+    int used;           // policy-private: time used at that level
+    int red;            // colour, while in a red-black tree
+    long long vruntime; // policy-private: weighted CPU time received
+    double estimate;    // policy-private: predicted length of the next CPU burst
+
+    // tasks that do I/O alternate CPU and I/O bursts
+    const struct io_burst *io;  // bursts after the first CPU burst, NULL if none
+    int nio;
+    int next_io;        // I/O bursts started so far
+    long long requested;    // time the current I/O request was made
+    long long blocked;      // time spent on I/O, waiting for the device included
+
+    // links for the list or the tree the task is queued on
+    union {
+        struct {
+            struct task *next;
+            struct task *prev;
+        };
+        struct {
+            struct task *left;
+            struct task *right;
+        };
+    };
+    struct task *parent;
+    struct task *origin; // for a job the engine released, its periodic task
 } Task;
 
+// ordering of a ready queue: negative if a should run before b
+typedef int (*task_cmp)(const Task *a, const Task *b);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,68 @@
+/**
+ * Task table operations
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "tasktable.h"
+
+#define INITIAL_CAPACITY 64
+
+void tt_init(struct task_table *table) {
+    table->count = 0;
+    table->capacity = 0;
+    table->tid = NULL;
+    table->burst = NULL;
+    table->remaining = NULL;
+    table->priority = NULL;
+    table->arrival = NULL;
+}
+
+void tt_free(struct task_table *table) {
+    free(table->tid);
+    free(table->burst);
+    free(table->remaining);
+    free(table->priority);
+    free(table->arrival);
+    tt_init(table);
+}
+
+static int32_t *grow(int32_t *column, int capacity) {
+    column = realloc(column, capacity * sizeof(int32_t));
+    if (!column) {
+        fprintf(stderr, "realloc failed in tt_add()\n");
+        exit(EXIT_FAILURE);
+    }
+    return column;
+}
+
+int tt_add(struct task_table *table, int tid, int priority, int burst, int arrival) {
+    if (table->count == table->capacity) {
+        int capacity = table->capacity ? table->capacity * 2 : INITIAL_CAPACITY;
+        table->tid = grow(table->tid, capacity);
+        table->burst = grow(table->burst, capacity);
+        table->remaining = grow(table->remaining, capacity);
+        table->priority = grow(table->priority, capacity);
+        table->arrival = grow(table->arrival, capacity);
+        table->capacity = capacity;
+    }
+
+    int row = table->count++;
+    table->tid[row] = tid;
+    table->burst[row] = burst;
+    table->remaining[row] = burst;
+    table->priority[row] = priority;
+    table->arrival[row] = arrival;
+    return row;
+}
+
+void tt_remove(struct task_table *table, int row) {
+    int last = --table->count;
+
+    table->tid[row] = table->tid[last];
+    table->burst[row] = table->burst[last];
+    table->remaining[row] = table->remaining[last];
+    table->priority[row] = table->priority[last];
+    table->arrival[row] = table->arrival[last];
+}
@@ -0,0 +1,34 @@
+/**
+ * Struct-of-arrays task table.
+ *
+ * Each per-task field is kept in its own contiguous int32 array, so a
+ * selection that only looks at one field (shortest burst, highest
+ * priority) streams through a single array instead of chasing Task
+ * pointers. Row i of every array describes the same task.
+ */
+
+#ifndef TASKTABLE_H
+#define TASKTABLE_H
+
+#include <stdint.h>
+
+struct task_table {
+    int count;
+    int capacity;
+    int32_t *tid;
+    int32_t *burst;
+    int32_t *remaining;
+    int32_t *priority;
+    int32_t *arrival;
+};
+
+void tt_init(struct task_table *table);
+void tt_free(struct task_table *table);
+
+// append a task and return its row
+int tt_add(struct task_table *table, int tid, int priority, int burst, int arrival);
+
+// remove a row in O(1) by moving the last row into its place
+void tt_remove(struct task_table *table, int row);
+
+#endif
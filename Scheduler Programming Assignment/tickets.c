@@ -0,0 +1,108 @@
+/**
+ * Ticket queue operations
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tickets.h"
+#include "task.h"
+
+#define INITIAL_CAPACITY 64
+
+void tq_init(struct ticket_queue *tq) {
+    memset(tq, 0, sizeof(*tq));
+}
+
+static void *grow(void *p, size_t size) {
+    p = realloc(p, size);
+    if (!p) {
+        fprintf(stderr, "realloc failed in tq_add()\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// add tickets to slot i (0-based) and every range sum covering it
+static void update(struct ticket_queue *tq, int i, long long delta) {
+    for (i++; i <= tq->capacity; i += i & -i)
+        tq->sums[i] += delta;
+}
+
+// double the slots and rebuild the tree over them in O(n)
+static void expand(struct ticket_queue *tq) {
+    int capacity = tq->capacity ? tq->capacity * 2 : INITIAL_CAPACITY;
+    int i;
+
+    tq->slots = grow(tq->slots, capacity * sizeof(Task *));
+    tq->tickets = grow(tq->tickets, capacity * sizeof(int));
+    tq->free = grow(tq->free, capacity * sizeof(int));
+    tq->sums = grow(tq->sums, (capacity + 1) * sizeof(long long));
+    tq->capacity = capacity;
+
+    memset(tq->sums, 0, (capacity + 1) * sizeof(long long));
+    for (i = 1; i <= capacity; i++) {
+        int parent = i + (i & -i);
+        if (i <= tq->high && tq->slots[i - 1])
+            tq->sums[i] += tq->tickets[i - 1];
+        if (parent <= capacity)
+            tq->sums[parent] += tq->sums[i];
+    }
+}
+
+// queue a task holding the given number of tickets
+void tq_add(struct ticket_queue *tq, Task *task, int tickets) {
+    int slot;
+
+    if (tq->nfree > 0) {
+        slot = tq->free[--tq->nfree];
+    } else {
+        if (tq->high == tq->capacity)
+            expand(tq);
+        slot = tq->high++;
+    }
+
+    tq->slots[slot] = task;
+    tq->tickets[slot] = tickets;
+    update(tq, slot, tickets);
+    tq->count++;
+    tq->total += tickets;
+}
+
+/*
+ * Remove and return the holder of the given ticket, counting from 0
+ * in slot order; NULL if the ticket is not below the total. The descent
+ * finds the first slot whose prefix sum exceeds the ticket.
+ */
+Task *tq_draw(struct ticket_queue *tq, long long ticket) {
+    int pos = 0;
+    int step;
+
+    if (ticket < 0 || ticket >= tq->total)
+        return NULL;
+
+    for (step = tq->capacity; step > 0; step >>= 1) {
+        if (pos + step <= tq->capacity && tq->sums[pos + step] <= ticket) {
+            pos += step;
+            ticket -= tq->sums[pos];
+        }
+    }
+
+    // pos is now the 0-based slot of the winner
+    Task *task = tq->slots[pos];
+    update(tq, pos, -tq->tickets[pos]);
+    tq->total -= tq->tickets[pos];
+    tq->slots[pos] = NULL;
+    tq->free[tq->nfree++] = pos;
+    tq->count--;
+    return task;
+}
+
+void tq_free(struct ticket_queue *tq) {
+    free(tq->slots);
+    free(tq->tickets);
+    free(tq->free);
+    free(tq->sums);
+    tq_init(tq);
+}
@@ -0,0 +1,33 @@
+/**
+ * Ticket-weighted ready queue for lottery scheduling.
+ *
+ * Each queued task holds a slot, and a Fenwick tree over the slots sums
+ * their tickets, so the holder of any ticket is found by one descent of
+ * the tree instead of a walk over every task. Freed slots are reused,
+ * so the tree only grows with the number of tasks queued at once.
+ */
+
+#ifndef TICKETS_H
+#define TICKETS_H
+
+#include "task.h"
+
+struct ticket_queue {
+    Task **slots;           // the task in each slot, NULL if free
+    int *tickets;           // the tickets it holds
+    long long *sums;        // Fenwick tree over the slots' tickets, 1-based
+    int capacity;           // slots allocated, a power of two
+    int high;               // slots ever handed out
+    int *free;              // stack of freed slots
+    int nfree;
+    int count;              // tasks queued
+    long long total;        // tickets queued
+};
+
+// add and draw are O(log n), add amortized over growing the tree
+void tq_init(struct ticket_queue *tq);
+void tq_add(struct ticket_queue *tq, Task *task, int tickets);
+Task *tq_draw(struct ticket_queue *tq, long long ticket);
+void tq_free(struct ticket_queue *tq);
+
+#endif
@@ -0,0 +1,327 @@
+/**
+ * Zero-copy schedule file loader
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "trace.h"
+#include "sched_format.h"
+
+int trace_open(struct trace *trace, const char *path) {
+    struct stat st;
+    int fd;
+
+    trace->path = path;
+    trace->data = NULL;
+    trace->size = 0;
+    memset(&trace->io, 0, sizeof(trace->io));
+
+    fd = open(path, O_RDONLY);
+    if (fd == -1 || fstat(fd, &st) == -1) {
+        perror(path);
+        if (fd != -1)
+            close(fd);
+        return -1;
+    }
+
+    if (st.st_size > 0) {
+        // private and writable so names can be terminated in place
+        trace->data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (trace->data == MAP_FAILED) {
+            perror(path);
+            trace->data = NULL;
+            close(fd);
+            return -1;
+        }
+        trace->size = st.st_size;
+        madvise(trace->data, trace->size, MADV_SEQUENTIAL);
+    }
+
+    close(fd);
+    return 0;
+}
+
+void trace_close(struct trace *trace) {
+    if (trace->data)
+        munmap(trace->data, trace->size);
+    trace->data = NULL;
+    trace->size = 0;
+    io_list_free(&trace->io);
+}
+
+void io_list_free(struct io_list *io) {
+    free(io->bursts);
+    memset(io, 0, sizeof(*io));
+}
+
+static void io_push(struct io_list *io, int device, int length, int cpu) {
+    struct io_burst *burst;
+
+    if (io->count == io->capacity) {
+        int capacity = io->capacity ? io->capacity * 2 : 8;
+        struct io_burst *bursts = realloc(io->bursts, capacity * sizeof(struct io_burst));
+        if (!bursts) {
+            fprintf(stderr, "realloc failed in io_push()\n");
+            exit(EXIT_FAILURE);
+        }
+        io->bursts = bursts;
+        io->capacity = capacity;
+    }
+    burst = &io->bursts[io->count++];
+    burst->device = device;
+    burst->io = length;
+    burst->cpu = cpu;
+}
+
+static char *skip_blanks(char *p, char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        p++;
+    return p;
+}
+
+// parse a decimal int at *p, advancing past it; returns -1 if there is none
+static int parse_int(char **p, char *end, int *value) {
+    char *s = skip_blanks(*p, end);
+    int negative = 0;
+    long n = 0;
+
+    if (s < end && (*s == '-' || *s == '+')) {
+        negative = (*s == '-');
+        s++;
+    }
+    if (s == end || *s < '0' || *s > '9')
+        return -1;
+    while (s < end && *s >= '0' && *s <= '9') {
+        n = n * 10 + (*s - '0');
+        if (n > INT_MAX)
+            return -1;
+        s++;
+    }
+
+    *value = negative ? (int)-n : (int)n;
+    *p = skip_blanks(s, end);
+    return 0;
+}
+
+int trace_parse_line(char *p, char *eol, char **name, int *priority, int *burst,
+                     struct io_list *io, int *arrival, int *deadline, int *period,
+                     const char **error) {
+    p = skip_blanks(p, eol);
+    if (p == eol)
+        return 0;
+
+    // name runs up to the first comma, minus trailing blanks
+    char *comma = memchr(p, ',', eol - p);
+    if (!comma) {
+        *error = "expected name, priority, burst[, arrival[, deadline[, period]]]";
+        return -1;
+    }
+    char *name_end = comma;
+    while (name_end > p && (name_end[-1] == ' ' || name_end[-1] == '\t'))
+        name_end--;
+    if (name_end == p) {
+        *error = "empty name";
+        return -1;
+    }
+
+    *arrival = 0;
+    *deadline = 0;
+    *period = 0;
+    char *q = comma + 1;
+    if (parse_int(&q, eol, priority) == -1) {
+        *error = "bad priority";
+        return -1;
+    }
+    if (q == eol || *q != ',') {
+        *error = "expected ',' after priority";
+        return -1;
+    }
+    q++;
+    if (parse_int(&q, eol, burst) == -1 || *burst < 0) {
+        *error = "bad burst";
+        return -1;
+    }
+
+    // then any number of /io[@device]/cpu
+    io->count = 0;
+    while (q != eol && *q == '/') {
+        int device = 0, length, cpu;
+
+        q++;
+        if (parse_int(&q, eol, &length) == -1 || length <= 0) {
+            *error = "bad I/O burst";
+            return -1;
+        }
+        if (q != eol && *q == '@') {
+            q++;
+            if (parse_int(&q, eol, &device) == -1 || device < 0 || device >= MAX_DEVICES) {
+                *error = "bad device";
+                return -1;
+            }
+        }
+        if (q == eol || *q != '/') {
+            *error = "expected a CPU burst after the I/O burst";
+            return -1;
+        }
+        q++;
+        if (parse_int(&q, eol, &cpu) == -1 || cpu <= 0) {
+            *error = "bad burst";
+            return -1;
+        }
+        io_push(io, device, length, cpu);
+    }
+    if (q != eol && *q == ',') {
+        q++;
+        if (parse_int(&q, eol, arrival) == -1 || *arrival < 0) {
+            *error = "bad arrival time";
+            return -1;
+        }
+    }
+    if (q != eol && *q == ',') {
+        q++;
+        if (parse_int(&q, eol, deadline) == -1 || *deadline < 0) {
+            *error = "bad deadline";
+            return -1;
+        }
+    }
+    if (q != eol && *q == ',') {
+        q++;
+        if (parse_int(&q, eol, period) == -1 || *period < 0) {
+            *error = "bad period";
+            return -1;
+        }
+    }
+    if (q != eol) {
+        *error = "trailing characters";
+        return -1;
+    }
+
+    *name_end = '\0';
+    *name = p;
+    return 1;
+}
+
+int trace_is_binary(const struct trace *trace) {
+    return trace->size >= sizeof(struct sched_header) &&
+           memcmp(trace->data, SCHED_MAGIC, strlen(SCHED_MAGIC)) == 0;
+}
+
+// the record size each version of the format uses
+static uint32_t record_size(uint32_t version) {
+    switch (version) {
+    case 1:
+        return SCHED_RECORD_V1_SIZE;
+    case 2:
+        return SCHED_RECORD_V2_SIZE;
+    case SCHED_VERSION:
+        return sizeof(struct sched_record);
+    }
+    return 0;
+}
+
+// a .sched file: records and names are used where they lie in the mapping
+static int load_binary(struct trace *trace, trace_add_fn add, void *arg) {
+    const struct sched_header *header = (const struct sched_header *)trace->data;
+    const struct sched_record *rec;
+    const struct sched_io *io = NULL;
+    uint32_t size = record_size(header->version);
+    uint64_t io_offset, io_count = 0;
+    char *names;
+    int errors = 0;
+    uint64_t i;
+
+    if (size == 0 || header->record_size != size ||
+        header->count > (trace->size - sizeof(*header)) / size ||
+        header->names_offset != sizeof(*header) + header->count * size ||
+        header->names_size > trace->size - header->names_offset ||
+        (header->names_size > 0 && trace->data[header->names_offset + header->names_size - 1] != '\0')) {
+        fprintf(stderr, "%s: bad .sched header\n", trace->path);
+        return 1;
+    }
+
+    // the I/O table runs from the aligned end of the names to the end of the file
+    io_offset = (header->names_offset + header->names_size + 3) & ~(uint64_t)3;
+    if (io_offset < trace->size) {
+        io = (const struct sched_io *)(trace->data + io_offset);
+        io_count = (trace->size - io_offset) / sizeof(struct sched_io);
+    }
+
+    // the table ends in a NUL, so any offset inside it is a valid string
+    // records of older versions are a prefix of the current ones, without
+    // deadline and period (version 1) or I/O bursts (versions 1 and 2)
+    names = trace->data + header->names_offset;
+    for (i = 0; i < header->count; i++) {
+        int deadline = 0, period = 0;
+        uint32_t first = 0, nio = 0, j;
+        int bad = 0;
+
+        rec = (const struct sched_record *)(trace->data + sizeof(*header) + i * size);
+        if (size >= SCHED_RECORD_V2_SIZE) {
+            deadline = rec->deadline;
+            period = rec->period;
+        }
+        if (size == sizeof(struct sched_record)) {
+            first = rec->io;
+            nio = rec->nio;
+            bad = first > io_count || nio > io_count - first;
+        }
+        trace->io.count = 0;
+        for (j = 0; j < nio && !bad; j++) {
+            const struct sched_io *b = &io[first + j];
+            bad = b->device < 0 || b->device >= MAX_DEVICES || b->io <= 0 || b->cpu <= 0;
+            io_push(&trace->io, b->device, b->io, b->cpu);
+        }
+        if (bad || rec->name >= header->names_size || rec->burst < 0 || rec->arrival < 0 ||
+            deadline < 0 || period < 0) {
+            fprintf(stderr, "%s: record %llu: malformed task\n", trace->path, (unsigned long long)i);
+            errors++;
+            continue;
+        }
+        add(arg, names + rec->name, rec->priority, rec->burst, trace->io.bursts, trace->io.count,
+            rec->arrival, deadline, period);
+    }
+    return errors;
+}
+
+int trace_load(struct trace *trace, trace_add_fn add, void *arg) {
+    if (trace_is_binary(trace))
+        return load_binary(trace, add, arg);
+
+    char *p = trace->data;
+    char *end = trace->data + trace->size;
+    int line = 0;
+    int errors = 0;
+
+    while (p < end) {
+        char *eol = memchr(p, '\n', end - p);
+        char *next = eol ? eol + 1 : end;
+        const char *error;
+        char *name;
+        int priority, burst, arrival, deadline, period;
+
+        if (!eol)
+            eol = end;
+        line++;
+
+        switch (trace_parse_line(p, eol, &name, &priority, &burst, &trace->io, &arrival, &deadline,
+                                 &period, &error)) {
+        case 1:
+            add(arg, name, priority, burst, trace->io.bursts, trace->io.count, arrival, deadline, period);
+            break;
+        case -1:
+            fprintf(stderr, "%s:%d: malformed task, %s\n", trace->path, line, error);
+            errors++;
+            break;
+        }
+        p = next;
+    }
+
+    return errors;
+}
@@ -0,0 +1,79 @@
+/**
+ * Loader for schedule files in the format
+ *
+ *  [name], [priority], [CPU burst][, arrival time[, deadline[, period]]]
+ *
+ * Tasks without an arrival time arrive at time 0. The deadline is
+ * relative to the arrival, and a task with a period is released again
+ * every period from its arrival on; 0 or absent means none.
+ *
+ * A task that does I/O gives a sequence of bursts in place of its CPU
+ * burst, alternating CPU and I/O and ending with CPU: 10/20/5 runs for
+ * 10, waits 20 on device 0, then runs for 5. An I/O burst may name its
+ * device, as in 10/20@1/5.
+ * The file is mapped into memory and parsed in place. Names are
+ * NUL-terminated inside the mapping and handed out without copying,
+ * so they stay valid until trace_close().
+ *
+ * Binary .sched files (see sched_format.h) are recognised by their
+ * magic number and loaded without any parsing: records are handed to
+ * the callback straight from the mapping, names included.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+
+#include "task.h"
+
+// the I/O bursts of the task just parsed; the array grows as needed and
+// is reused from one task to the next
+struct io_list {
+    struct io_burst *bursts;
+    int count;
+    int capacity;
+};
+
+struct trace {
+    const char *path;
+    char *data;
+    size_t size;
+    struct io_list io;
+};
+
+/*
+ * Called once per task, in file order, with the arg given to
+ * trace_load(). io points to the task's nio I/O bursts, each followed
+ * by a CPU burst, and is only valid during the call.
+ */
+typedef void (*trace_add_fn)(void *arg, char *name, int priority, int burst,
+                             const struct io_burst *io, int nio, int arrival,
+                             int deadline, int period);
+
+// map the file; returns 0 on success, -1 (with a message on stderr) on error
+int trace_open(struct trace *trace, const char *path);
+
+/*
+ * Parse the text line [p, eol) in place. Returns 1 and fills in the
+ * task, with its name NUL-terminated inside the line and its I/O bursts
+ * in io; 0 for a blank line; -1 with *error set if the line is
+ * malformed.
+ */
+int trace_parse_line(char *p, char *eol, char **name, int *priority, int *burst,
+                     struct io_list *io, int *arrival, int *deadline, int *period,
+                     const char **error);
+
+void io_list_free(struct io_list *io);
+
+// whether the mapped file is in the binary .sched format
+int trace_is_binary(const struct trace *trace);
+
+// parse every line (or record) and pass it to add; returns the number
+// of malformed lines
+int trace_load(struct trace *trace, trace_add_fn add, void *arg);
+
+// unmap the file, invalidating all names handed out
+void trace_close(struct trace *trace);
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * Workload operations
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "workload.h"
+
+#define INITIAL_CAPACITY 64
+
+void workload_init(struct workload *workload) {
+    workload->specs = NULL;
+    workload->count = 0;
+    workload->capacity = 0;
+    workload->io = NULL;
+    workload->io_count = 0;
+    workload->io_capacity = 0;
+}
+
+void workload_free(struct workload *workload) {
+    free(workload->specs);
+    free(workload->io);
+    workload_init(workload);
+}
+
+static void add_io(struct workload *workload, const struct io_burst *io, int nio) {
+    if (workload->io_count + nio > workload->io_capacity) {
+        int capacity = workload->io_capacity ? workload->io_capacity : INITIAL_CAPACITY;
+        struct io_burst *bursts;
+
+        while (capacity < workload->io_count + nio)
+            capacity *= 2;
+        bursts = realloc(workload->io, capacity * sizeof(struct io_burst));
+        if (!bursts) {
+            fprintf(stderr, "realloc failed in workload_add()\n");
+            exit(EXIT_FAILURE);
+        }
+        workload->io = bursts;
+        workload->io_capacity = capacity;
+    }
+    memcpy(&workload->io[workload->io_count], io, nio * sizeof(struct io_burst));
+    workload->io_count += nio;
+}
+
+void workload_add(void *arg, char *name, int priority, int burst,
+                  const struct io_burst *io, int nio, int arrival, int deadline, int period) {
+    struct workload *workload = arg;
+
+    if (workload->count == workload->capacity) {
+        int capacity = workload->capacity ? workload->capacity * 2 : INITIAL_CAPACITY;
+        struct task_spec *specs = realloc(workload->specs, capacity * sizeof(struct task_spec));
+        if (!specs) {
+            fprintf(stderr, "realloc failed in workload_add()\n");
+            exit(EXIT_FAILURE);
+        }
+        workload->specs = specs;
+        workload->capacity = capacity;
+    }
+
+    struct task_spec *spec = &workload->specs[workload->count++];
+    spec->name = name;
+    spec->priority = priority;
+    spec->burst = burst;
+    spec->io = workload->io_count;
+    spec->nio = nio;
+    spec->arrival = arrival;
+    spec->deadline = deadline;
+    spec->period = period;
+    if (nio > 0)
+        add_io(workload, io, nio);
+}
+
+void task_init(Task *task, int tid, const struct task_spec *spec, const struct io_burst *io) {
+    // zero the policy-private fields and the links along with the rest
+    memset(task, 0, sizeof(*task));
+    task->name = spec->name;
+    task->tid = tid;
+    task->priority = spec->priority;
+    task->burst = spec->burst;
+    task->initial_burst = spec->burst;
+    task->arrival = spec->arrival;
+    // a periodic task without a deadline is due by its next release
+    task->deadline = spec->period > 0 && spec->deadline == 0 ? spec->period : spec->deadline;
+    task->period = spec->period;
+    task->io = io;
+    task->nio = spec->nio;
+}
+
+const struct io_burst *workload_io(const struct workload *workload, const struct task_spec *spec) {
+    return spec->nio > 0 ? &workload->io[spec->io] : NULL;
+}
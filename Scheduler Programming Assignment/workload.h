@@ -0,0 +1,47 @@
+/**
+ * A parsed schedule: one immutable spec per task, in file order.
+ *
+ * Several schedulers can share one workload, even concurrently; each
+ * copies the specs into its own mutable tasks.
+ */
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "task.h"
+
+struct task_spec {
+    char *name;
+    int priority;
+    int burst;
+    int io;                     // index of the task's first I/O burst in the workload
+    int nio;
+    int arrival;
+    int deadline;
+    int period;
+};
+
+struct workload {
+    struct task_spec *specs;
+    int count;
+    int capacity;
+    struct io_burst *io;        // every task's I/O bursts, back to back
+    int io_count;
+    int io_capacity;
+};
+
+void workload_init(struct workload *workload);
+void workload_free(struct workload *workload);
+
+// append a task; matches trace_add_fn so a trace can be loaded straight in
+void workload_add(void *workload, char *name, int priority, int burst,
+                  const struct io_burst *io, int nio, int arrival, int deadline, int period);
+
+// a task's I/O bursts, NULL if it has none
+const struct io_burst *workload_io(const struct workload *workload, const struct task_spec *spec);
+
+// set every field of a task that has not arrived yet from its spec; io
+// holds its spec->nio I/O bursts and must outlive the task
+void task_init(Task *task, int tid, const struct task_spec *spec, const struct io_burst *io);
+
+#endif